@@ -0,0 +1,369 @@
+/* apsp.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * This file runs shortest path searches from every vertex of a graph, spread
+ * over a pool of threads, for commands like the network diameter.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "graph.h"
+#include "apsp.h"
+#include "floyd.h"
+#include "delta.h"
+#include "counters.h"
+
+#define ECC_TOLERANCE 1e-9		//Relative gap at which two bounds are taken as equal
+
+/* State shared by the threads of one AllSourcesDiameter call */
+typedef  struct {
+	graph_t		*G;
+	int			Engine;
+	int			Verbose;
+	int			NextSource;		//Next source to hand out, taken atomically
+	double		*Ecc;			//Each source writes only its own entry
+} DiameterJob;
+
+/* Each thread's own result, merged once all the threads finish */
+typedef  struct {
+	DiameterJob		*Job;
+	DiameterResult	Result;
+	pthread_t		Thread;
+} DiameterWorker;
+
+
+/* Number of threads to use when Threads is 0: one per online processor */
+int apsp_thread_count(int Threads)
+{
+	long n;
+
+	if(Threads > 0) return Threads;
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+	return (n > 0) ? (int) n : 1;
+}
+
+/* Keeps the longer path, or the one from the lower source on a tie, so the
+ * result doesn't depend on how the sources were split between threads
+ */
+static void KeepLonger(DiameterResult *Best, double Max, int LSource, int LDest)
+{
+	if(Best->Diameter < Max || (Best->Diameter == Max && LSource < Best->Source))
+	{
+		Best->Diameter = Max;
+		Best->Source = LSource;
+		Best->Dest = LDest;
+	}
+}
+
+/* Fills in the radius and center once every eccentricity is exact */
+static void ExactRadius(DiameterResult *R, int NumVert)
+{
+	int i;
+
+	R->EccLow = (double *) malloc(NumVert * sizeof(double));
+	R->Radius = FLT_MAX;
+	R->Center = 0;
+	for(i = 0; i < NumVert; i++)
+	{
+		R->EccLow[i] = R->Ecc[i];
+		if(R->Ecc[i] < R->Radius)
+		{
+			R->Radius = R->Ecc[i];
+			R->Center = i;
+		}
+	}
+}
+
+/* Thread body: takes sources until none are left, searching each with the
+ * thread's own workspace */
+static void *DiameterThread(void *Arg)
+{
+	DiameterWorker *W = (DiameterWorker *) Arg;
+	DiameterJob *Job = W->Job;
+	int i, j, IsInfinity;
+	double Max;
+	SPWorkspace *WS = workspace_construct();
+
+	WS->Threads = 1;					//The sources are already spread over the threads
+	for(;;)
+	{
+		i = __atomic_fetch_add(&Job->NextSource, 1, __ATOMIC_RELAXED);
+		if(i >= Job->G->NumVert) break;
+
+		ShortestPathWith(Job->G, Job->Engine, i, Job->Verbose, WS);
+
+		j = -1;
+		IsInfinity = 0;
+		Max = FindMaxElement(WS->Dist, Job->G->NumVert, &j, &IsInfinity);
+		if(IsInfinity) W->Result.IsInfinity = TRUE;
+		if(j >= 0) KeepLonger(&W->Result, Max, i, j);
+		Job->Ecc[i] = IsInfinity ? FLT_MAX : Max;
+	}
+	workspace_destruct(WS);
+	counters_flush();
+	return NULL;
+}
+
+/* Finds the diameter of G by a search from every vertex, with the sources
+ * shared between Threads threads (0 for one per processor)
+ */
+void AllSourcesDiameter(graph_t *G, int Engine, int Threads, int Verbose, DiameterResult *R)
+{
+	int t;
+	DiameterJob Job;
+	DiameterWorker *Workers;
+
+	/* Anything the engines build lazily must exist before the threads share G */
+	graph_finalize(G);
+	if(Engine == SP_AUTO) Engine = graph_pick_engine(G);
+	graph_weight_scale(G);
+	graph_delta_width(G);
+
+	Threads = apsp_thread_count(Threads);
+	if(Threads > G->NumVert) Threads = G->NumVert;
+	if(Threads < 1) Threads = 1;
+
+	Job.G = G;
+	Job.Engine = Engine;
+	Job.Verbose = (Threads == 1) ? Verbose : FALSE;	//Prints from threads would mix
+	Job.NextSource = 0;
+	Job.Ecc = (double *) malloc(G->NumVert * sizeof(double));
+
+	Workers = (DiameterWorker *) malloc(Threads * sizeof(DiameterWorker));
+	for(t = 0; t < Threads; t++)
+	{
+		Workers[t].Job = &Job;
+		Workers[t].Result.Diameter = -1;
+		Workers[t].Result.Source = -1;
+		Workers[t].Result.Dest = -1;
+		Workers[t].Result.IsInfinity = FALSE;
+	}
+
+	/* The calling thread works as the last worker */
+	for(t = 0; t < Threads - 1; t++)
+	{
+		if(pthread_create(&Workers[t].Thread, NULL, DiameterThread, &Workers[t]) != 0)
+		{
+			fprintf(stderr, "Failed to start thread %d\n", t);
+			exit(1);
+		}
+	}
+	DiameterThread(&Workers[Threads - 1]);
+	for(t = 0; t < Threads - 1; t++)
+		pthread_join(Workers[t].Thread, NULL);
+
+	/* Reduce the results of the workers */
+	R->Diameter = -1;
+	R->Source = -1;
+	R->Dest = -1;
+	R->IsInfinity = FALSE;
+	for(t = 0; t < Threads; t++)
+	{
+		if(Workers[t].Result.IsInfinity) R->IsInfinity = TRUE;
+		if(Workers[t].Result.Source >= 0)
+			KeepLonger(R, Workers[t].Result.Diameter, Workers[t].Result.Source, Workers[t].Result.Dest);
+	}
+	free(Workers);
+
+	R->Ecc = Job.Ecc;
+	ExactRadius(R, G->NumVert);
+	R->Searches = G->NumVert;
+	R->DiameterSearches = G->NumVert;
+	R->PathPred = NULL;
+	R->PathDist = NULL;
+}
+
+/* Finds the diameter of G from its Floyd-Warshall distance matrix */
+void FloydDiameter(graph_t *G, DiameterResult *R)
+{
+	int i, j, IsInfinity;
+	double Max;
+	FloydResult *F;
+
+	F = FloydWarshall(G);
+
+	R->Diameter = -1;
+	R->Source = R->Dest = -1;
+	R->IsInfinity = FALSE;
+	R->Ecc = (double *) malloc(G->NumVert * sizeof(double));
+	for(i = 0; i < G->NumVert; i++)
+	{
+		j = -1;
+		IsInfinity = 0;
+		Max = FindMaxElement(F->Dist + (size_t) i * F->Stride, G->NumVert, &j, &IsInfinity);
+		if(IsInfinity) R->IsInfinity = TRUE;
+		if(j >= 0) KeepLonger(R, Max, i, j);
+		R->Ecc[i] = IsInfinity ? FLT_MAX : Max;
+	}
+
+	/* The longest path comes from the next-hop matrix, without another search */
+	R->PathPred = NULL;
+	R->PathDist = NULL;
+	if(R->Source >= 0) floyd_path(F, R->Source, &R->PathPred, &R->PathDist);
+	floyd_free(F);
+
+	ExactRadius(R, G->NumVert);
+	R->Searches = R->DiameterSearches = 0;
+}
+
+/* Frees the eccentricity tables of a result */
+void diameter_result_free(DiameterResult *R)
+{
+	free(R->Ecc); free(R->EccLow); free(R->PathPred); free(R->PathDist);
+	R->Ecc = R->EccLow = NULL;
+	R->PathPred = NULL;
+	R->PathDist = NULL;
+}
+
+/* TRUE if the two bounds are the same up to rounding */
+static int BoundsMeet(double Low, double High)
+{
+	return fabs(High - Low) <= ECC_TOLERANCE * (High > 1 ? High : 1);
+}
+
+/* Finds the exact diameter, radius and center of G with as few searches as
+ * the eccentricity bounds allow (Takes and Kosters' bounding method, for
+ * directed graphs).  Searching forward and backward from a vertex v gives its
+ * eccentricity e(v) and, for every other vertex w,
+ *
+ *		max(d(w,v), e(v) - d(v,w))  <=  e(w)  <=  d(w,v) + e(v)
+ *
+ * The next vertex searched is the one with the largest upper bound, for the
+ * diameter, or the smallest lower bound, for the radius, in turn.  The search
+ * stops once the diameter and radius are proven, or, with FullTable, once
+ * every eccentricity is exact.
+ *
+ * The bounds only hold when every vertex can reach every other, so any other
+ * graph falls back on AllSourcesDiameter.
+ */
+void BoundingDiameter(graph_t *G, int Engine, int Threads, int FullTable, DiameterResult *R)
+{
+	int i, v, w, n, Open, PickHigh = TRUE, *Done;
+	double Ev, DiamLow, DiamHigh, RadLow, RadHigh, *Lo, *Hi, *Dist, *RDist;
+	SPWorkspace *WS, *RWS;				//For the forward and backward searches
+
+	n = G->NumVert;
+	graph_reverse(G);
+	if(Engine == SP_AUTO) Engine = graph_pick_engine(G);
+
+	Lo = (double *) malloc(n * sizeof(double));
+	Hi = (double *) malloc(n * sizeof(double));
+	Done = (int *) malloc(n * sizeof(int));
+	WS = workspace_construct();
+	WS->Threads = Threads;				//The searches run one at a time
+	RWS = workspace_construct();
+	for(w = 0; w < n; w++)
+	{
+		Lo[w] = 0;
+		Hi[w] = FLT_MAX;
+		Done[w] = FALSE;
+	}
+	R->Searches = 0;
+	R->DiameterSearches = -1;
+	R->IsInfinity = FALSE;
+	R->PathPred = NULL;
+	R->PathDist = NULL;
+
+	/* Start from the vertex with the most edges */
+	v = 0;
+	for(w = 1; w < n; w++)
+	{
+		if(G->EdgeOffset[w+1] - G->EdgeOffset[w] + G->RevOffset[w+1] - G->RevOffset[w] >
+		   G->EdgeOffset[v+1] - G->EdgeOffset[v] + G->RevOffset[v+1] - G->RevOffset[v]) v = w;
+	}
+
+	for(;;)
+	{
+		ShortestPathWith(G, Engine, v, FALSE, WS);
+		ShortestPathReverseWith(G, v, FALSE, RWS);
+		R->Searches += 2;
+		Dist = WS->Dist;
+		RDist = RWS->Dist;
+
+		/* Give up on the bounds if some vertex is out of reach */
+		for(w = 0; w < n; w++)
+			if(Dist[w] == FLT_MAX || RDist[w] == FLT_MAX) break;
+		if(w < n)
+		{
+			workspace_destruct(WS); workspace_destruct(RWS); free(Lo); free(Hi); free(Done);
+			AllSourcesDiameter(G, Engine, Threads, FALSE, R);
+			return;
+		}
+
+		Ev = 0;
+		for(w = 0; w < n; w++)
+			if(Ev < Dist[w]) Ev = Dist[w];
+		Lo[v] = Hi[v] = Ev;
+		Done[v] = TRUE;
+
+		/* Tighten the bounds of the other vertices */
+		for(w = 0; w < n; w++)
+		{
+			if(Done[w]) continue;
+			if(Lo[w] < RDist[w]) Lo[w] = RDist[w];
+			if(Lo[w] < Ev - Dist[w]) Lo[w] = Ev - Dist[w];
+			if(Hi[w] > RDist[w] + Ev) Hi[w] = RDist[w] + Ev;
+			if(BoundsMeet(Lo[w], Hi[w])) Done[w] = TRUE;
+		}
+
+		/* Bounds on the diameter and radius over every vertex */
+		DiamLow = DiamHigh = -1;
+		RadLow = RadHigh = FLT_MAX;
+		for(w = 0, Open = 0; w < n; w++)
+		{
+			if(DiamLow < Lo[w]) DiamLow = Lo[w];
+			if(DiamHigh < Hi[w]) DiamHigh = Hi[w];
+			if(RadLow > Lo[w]) RadLow = Lo[w];
+			if(RadHigh > Hi[w]) RadHigh = Hi[w];
+			if(!Done[w]) Open++;
+		}
+		if(R->DiameterSearches < 0 && BoundsMeet(DiamLow, DiamHigh)) R->DiameterSearches = R->Searches;
+
+		if(Open == 0) break;
+		if(!FullTable && R->DiameterSearches >= 0 && BoundsMeet(RadLow, RadHigh)) break;
+
+		/* Next, the open vertex that could most raise the diameter or lower the radius */
+		v = -1;
+		for(w = 0; w < n; w++)
+		{
+			if(Done[w]) continue;
+			if(v < 0 || (PickHigh ? Hi[w] > Hi[v] : Lo[w] < Lo[v])) v = w;
+		}
+		PickHigh = !PickHigh;
+	}
+
+	/* The first vertex with the largest eccentricity starts the longest path */
+	R->Diameter = DiamLow;
+	R->Radius = RadHigh;
+	R->Source = R->Center = -1;
+	for(w = 0; w < n; w++)
+	{
+		if(R->Source < 0 && BoundsMeet(R->Diameter, Hi[w]) && Done[w]) R->Source = w;
+		if(R->Center < 0 && Hi[w] == RadHigh) R->Center = w;
+	}
+	if(R->Source < 0)
+	{
+		for(w = R->Source = 0; w < n; w++)
+			if(Lo[w] > Lo[R->Source]) R->Source = w;
+	}
+	if(R->DiameterSearches < 0) R->DiameterSearches = R->Searches;
+
+	/* One more search finds the other end of the longest path */
+	ShortestPathWith(G, Engine, R->Source, FALSE, WS);
+	R->Searches++;
+	i = 0;
+	FindMaxElement(WS->Dist, n, &R->Dest, &i);
+
+	R->Ecc = Hi;
+	R->EccLow = Lo;
+	free(Done);
+	workspace_destruct(WS); workspace_destruct(RWS);
+}
@@ -0,0 +1,37 @@
+/* apsp.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * Drivers that run a shortest path search from every vertex of a graph.
+ */
+
+/* Methods for the network diameter, chosen with -m in lab6 */
+#define DIAM_ALL_SOURCES 1		//A search from every vertex
+#define DIAM_BOUNDING 2			//Searches chosen by eccentricity bounds
+#define DIAM_FLOYD 3			//Floyd-Warshall over the whole matrix
+
+/* The longest of all the shortest paths in a graph, and the eccentricity of
+ * each vertex: the cost of the longest shortest path out of it
+ */
+typedef  struct {
+	double	Diameter;		//-1 if no vertex can reach another
+	int		Source;			//Ends of the longest path, -1 if there is none
+	int		Dest;
+	int		IsInfinity;		//TRUE if some pair has no path
+	double	Radius;			//Smallest eccentricity, FLT_MAX if every vertex misses one
+	int		Center;			//A vertex with the smallest eccentricity
+	double	*Ecc;			//Eccentricity of each vertex, FLT_MAX if it misses one
+	double	*EccLow;		//Equal to Ecc unless only bounds were found
+	int		Searches;		//Single source searches that were run
+	int		DiameterSearches;	//Searches run before the diameter was known
+	int		*PathPred;		//Predecessors and costs from Source, for printing the
+	double	*PathDist;		//longest path, or NULL if the method didn't keep them
+} DiameterResult;
+
+int apsp_thread_count(int Threads);
+void AllSourcesDiameter(graph_t *G, int Engine, int Threads, int Verbose, DiameterResult *R);
+void BoundingDiameter(graph_t *G, int Engine, int Threads, int FullTable, DiameterResult *R);
+void FloydDiameter(graph_t *G, DiameterResult *R);
+void diameter_result_free(DiameterResult *R);
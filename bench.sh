@@ -0,0 +1,60 @@
+#!/bin/sh
+# bench.sh
+# Roderick "Rance" White
+# roderiw
+# Lab6: Graphs
+# ECE 2230, Fall 2020
+#
+# Times each graph operation over a sweep of graph sizes, densities and
+# types, and collects the median and 95th percentile wall times in a CSV
+# file.  Run with "make bench".  The sweep can be changed from the
+# environment:
+#
+#   OUT          CSV file, replaced on each run (default bench.csv)
+#   RUNS         timed runs of each case (default 5)
+#   WARMUPS      untimed runs before them (default 1)
+#   SIZES        vertex counts for random graphs (-g 4)
+#   DENSE_SIZES  vertex counts for strongly-connected graphs (-g 3)
+#   ADJACENT     values of -a for random graphs
+#   OPS          operations (-h) to time
+#   QUERIES      S D pairs for -h 7
+
+OUT=${OUT:-bench.csv}
+RUNS=${RUNS:-5}
+WARMUPS=${WARMUPS:-1}
+SIZES=${SIZES:-"500 1000 2000 4000"}
+DENSE_SIZES=${DENSE_SIZES:-"100 200 400 800"}
+ADJACENT=${ADJACENT:-"5 10 20"}
+OPS=${OPS:-"1 2 3 5 6 7"}
+QUERIES=${QUERIES:-1000}
+
+LAB6=./lab6
+QUERYFILE=bench_queries.txt
+
+rm -f "$OUT"
+
+# One case: graph options, vertex count, operation
+run() {
+	opts=$1; n=$2; op=$3
+	extra=""
+	if [ "$op" = 7 ]; then
+		awk -v n="$n" -v q="$QUERIES" 'BEGIN { srand(1); for(i = 0; i < q; i++) print int(rand() * n), int(rand() * n) }' > "$QUERYFILE"
+		extra="-b $QUERYFILE"
+	fi
+	echo "-h $op $opts -n $n"
+	$LAB6 $opts -n "$n" -h "$op" -s 0 -d $((n - 1)) $extra -R "$RUNS" -W "$WARMUPS" -B "$OUT" > /dev/null || exit 1
+}
+
+for op in $OPS; do
+	for n in $SIZES; do
+		for a in $ADJACENT; do
+			run "-g 4 -a $a" "$n" "$op"
+		done
+	done
+	for n in $DENSE_SIZES; do
+		run "-g 3" "$n" "$op"
+	done
+done
+
+rm -f "$QUERYFILE"
+echo "Results in $OUT"
@@ -0,0 +1,132 @@
+/* cache.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * This file contains a cache of the Pred and ShDis arrays of shortest path
+ * searches, so that a source asked for again costs only a lookup.  The
+ * entries are kept in a list from most to least recently used, and the least
+ * recently used are dropped while the entries take more than the budget.
+ * Every change to an edge raises G->Version, and the whole cache is emptied
+ * the next time it is used after one.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "graph.h"
+#include "cache.h"
+
+
+/* Bytes held by one entry of a cache for G */
+static size_t EntryBytes(graph_t *G)
+{
+	return sizeof(TreeEntry) + G->NumVert * (sizeof(int) + sizeof(double));
+}
+
+/* Creates an empty cache for searches of G with Engine, holding at most
+ * Budget bytes of entries, but always at least the last one found
+ */
+tree_cache_t* tree_cache_construct(graph_t *G, int Engine, size_t Budget)
+{
+	tree_cache_t *C;
+
+	C = (tree_cache_t *) malloc(sizeof(tree_cache_t));
+	C->G = G;
+	C->Engine = Engine;
+	C->Version = G->Version;
+	C->Budget = Budget;
+	C->Bytes = 0;
+	C->BySource = (TreeEntry **) calloc(G->NumVert, sizeof(TreeEntry *));
+	C->Newest = C->Oldest = NULL;
+	C->Hits = C->Misses = 0;
+	return C;
+}
+
+/* Takes entry T out of the list of C */
+static void Unlink(tree_cache_t *C, TreeEntry *T)
+{
+	if(T->Newer != NULL) T->Newer->Older = T->Older;
+	else C->Newest = T->Older;
+	if(T->Older != NULL) T->Older->Newer = T->Newer;
+	else C->Oldest = T->Newer;
+}
+
+/* Puts entry T at the front of the list of C */
+static void PushNewest(tree_cache_t *C, TreeEntry *T)
+{
+	T->Newer = NULL;
+	T->Older = C->Newest;
+	if(C->Newest != NULL) C->Newest->Newer = T;
+	else C->Oldest = T;
+	C->Newest = T;
+}
+
+/* Drops the least recently used entry of C */
+static void DropOldest(tree_cache_t *C)
+{
+	TreeEntry *T = C->Oldest;
+
+	Unlink(C, T);
+	C->BySource[T->Source] = NULL;
+	C->Bytes -= EntryBytes(C->G);
+	free(T->Pred); free(T->ShDis); free(T);
+}
+
+/* Empties C if the graph has changed since its entries were found */
+static void CheckVersion(tree_cache_t *C)
+{
+	if(C->Version == C->G->Version) return;
+	while(C->Oldest != NULL) DropOldest(C);
+	C->Version = C->G->Version;
+}
+
+/* Frees cache C and all of its entries */
+void tree_cache_destruct(tree_cache_t *C)
+{
+	while(C->Oldest != NULL) DropOldest(C);
+	free(C->BySource);
+	free(C);
+}
+
+/* Returns TRUE if the search from LSource is in C and still up to date */
+int tree_cache_has(tree_cache_t *C, int LSource)
+{
+	CheckVersion(C);
+	return C->BySource[LSource] != NULL;
+}
+
+/* Gives the Pred and ShDis arrays of a search from LSource, found now if it
+ * isn't cached.  The arrays belong to the cache, and are only good until the
+ * next call on it or the next change to the graph.
+ */
+void tree_cache_get(tree_cache_t *C, int LSource, int **Pred, double **ShDis)
+{
+	TreeEntry *T;
+
+	CheckVersion(C);
+	T = C->BySource[LSource];
+	if(T != NULL)
+	{
+		C->Hits++;
+		Unlink(C, T);
+	}
+	else
+	{
+		C->Misses++;
+		T = (TreeEntry *) malloc(sizeof(TreeEntry));
+		T->Source = LSource;
+		ShortestPathBy(C->G, C->Engine, LSource, FALSE, &T->Pred, &T->ShDis);
+		C->BySource[LSource] = T;
+		C->Bytes += EntryBytes(C->G);
+
+		/* Make room, keeping at least this entry */
+		while(C->Bytes > C->Budget && C->Oldest != NULL)
+			DropOldest(C);
+	}
+	PushNewest(C, T);
+
+	*Pred = T->Pred;
+	*ShDis = T->ShDis;
+}
@@ -0,0 +1,36 @@
+/* cache.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * A cache of shortest path searches by source, dropping the least recently
+ * used once a memory budget is reached.  Include graph.h before this file.
+ */
+
+/* One cached search, in a list from most to least recently used */
+typedef struct TreeEntry {
+	int		Source;
+	int		*Pred;
+	double	*ShDis;
+	struct TreeEntry *Newer;
+	struct TreeEntry *Older;
+} TreeEntry;
+
+typedef  struct {
+	graph_t	*G;
+	int		Engine;					//Engine for ShortestPathBy
+	unsigned long Version;			//G->Version the entries were found for
+	size_t	Budget;					//Bytes the entries may take up
+	size_t	Bytes;
+	TreeEntry **BySource;			//Entry for each source, NULL if none
+	TreeEntry *Newest;
+	TreeEntry *Oldest;
+	long	Hits;
+	long	Misses;
+} tree_cache_t;
+
+tree_cache_t* tree_cache_construct(graph_t *G, int Engine, size_t Budget);
+void tree_cache_destruct(tree_cache_t *C);
+int tree_cache_has(tree_cache_t *C, int LSource);
+void tree_cache_get(tree_cache_t *C, int LSource, int **Pred, double **ShDis);
@@ -0,0 +1,70 @@
+/* counters.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * This file collects the counters from counters.h.  Threads count into their
+ * own copy so that counting costs no more than an add, and a thread adds its
+ * copy to the totals with counters_flush before it finishes.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "counters.h"
+
+__thread counters_t Counters;
+
+static counters_t Totals;
+static pthread_mutex_t TotalsLock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* Adds the counters of the calling thread to the totals and clears them */
+void counters_flush(void)
+{
+	pthread_mutex_lock(&TotalsLock);
+	Totals.EdgesScanned += Counters.EdgesScanned;
+	Totals.Relaxations += Counters.Relaxations;
+	Totals.Settled += Counters.Settled;
+	Totals.Inserts += Counters.Inserts;
+	Totals.DecreaseKeys += Counters.DecreaseKeys;
+	Totals.Removes += Counters.Removes;
+	Totals.BytesAllocated += Counters.BytesAllocated;
+	if(Counters.PeakQueue > Totals.PeakQueue) Totals.PeakQueue = Counters.PeakQueue;
+	pthread_mutex_unlock(&TotalsLock);
+	memset(&Counters, 0, sizeof(Counters));
+}
+
+/* Stores the totals, including the calling thread's counters, in *Total and
+ * starts counting again from zero
+ */
+void counters_take(counters_t *Total)
+{
+	counters_flush();
+	pthread_mutex_lock(&TotalsLock);
+	*Total = Totals;
+	memset(&Totals, 0, sizeof(Totals));
+	pthread_mutex_unlock(&TotalsLock);
+}
+
+/* Prints the counters in C */
+void counters_print(const counters_t *C)
+{
+	printf("Edges scanned: %lld, relaxations: %lld, vertices settled: %lld\n",
+			C->EdgesScanned, C->Relaxations, C->Settled);
+	printf("Queue inserts: %lld, decrease-keys: %lld, removes: %lld, peak size: %lld\n",
+			C->Inserts, C->DecreaseKeys, C->Removes, C->PeakQueue);
+	printf("Bytes allocated: %lld\n\n", C->BytesAllocated);
+}
+
+/* Writes the counters in C to Out as one line of JSON, labeled with Name */
+void counters_json(FILE *Out, const char *Name, const counters_t *C)
+{
+	fprintf(Out, "{\"name\": \"%s\", \"edges_scanned\": %lld, \"relaxations\": %lld, \"settled\": %lld, "
+				 "\"inserts\": %lld, \"decrease_keys\": %lld, \"removes\": %lld, \"peak_queue\": %lld, "
+				 "\"bytes_allocated\": %lld}\n",
+			Name, C->EdgesScanned, C->Relaxations, C->Settled, C->Inserts, C->DecreaseKeys,
+			C->Removes, C->PeakQueue, C->BytesAllocated);
+}
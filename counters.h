@@ -0,0 +1,38 @@
+/* counters.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * Counts of the work done by the searches, the priority queues and graph
+ * construction.  The COUNT macros only do something when built with
+ * -DCOUNTERS (make COUNTERS=1); otherwise they compile to nothing.  Each
+ * thread counts into its own copy, which counters_flush adds to the totals.
+ * Include stdio.h before this file.
+ */
+
+typedef  struct {
+	long long	EdgesScanned;		//Edges looked at from a confirmed vertex
+	long long	Relaxations;		//Edges that lowered the cost of their far end
+	long long	Settled;			//Vertices confirmed
+	long long	Inserts;			//Queue inserts of a vertex not yet queued
+	long long	DecreaseKeys;		//Queue inserts that lowered a queued key
+	long long	Removes;
+	long long	PeakQueue;			//Most vertices in any one queue at once
+	long long	BytesAllocated;
+} counters_t;
+
+extern __thread counters_t Counters;
+
+#ifdef COUNTERS
+#define COUNT(Field, n)		(Counters.Field += (n))
+#define COUNT_PEAK(n)		((void) ((n) > Counters.PeakQueue && (Counters.PeakQueue = (n))))
+#else
+#define COUNT(Field, n)		((void) 0)
+#define COUNT_PEAK(n)		((void) 0)
+#endif
+
+void counters_flush(void);
+void counters_take(counters_t *Total);
+void counters_print(const counters_t *C);
+void counters_json(FILE *Out, const char *Name, const counters_t *C);
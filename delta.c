@@ -0,0 +1,494 @@
+/* delta.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * This file finds the shortest paths from one vertex by delta-stepping.  The
+ * costs are split into buckets of graph_delta_width, which are emptied in
+ * order.  The vertices of a bucket are shared between the threads, which
+ * lower the costs of their neighbors with an atomic compare and swap and
+ * keep the neighbors in buckets of their own.  Edges no heavier than the
+ * bucket width may lead back into the bucket being emptied, so they are
+ * followed again until it stays empty; the heavier ones are followed once,
+ * after it is.
+ *
+ * The costs found are the same as those of the other engines.  The threads
+ * don't agree on which edge lowered a cost last, so the predecessors are
+ * picked once the costs are known: the lowest numbered vertex whose cost
+ * plus its edge gives the cost of the vertex.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <pthread.h>
+
+#include "graph.h"
+#include "delta.h"
+#include "apsp.h"
+#include "counters.h"
+#include "trace.h"
+
+#define DELTA_LAST_BUCKET 4e18		//Costs past this many buckets share the last one
+
+/* A growing list of vertices */
+typedef  struct {
+	int		Count;
+	int		Size;
+	int		*Item;
+} DeltaList;
+
+/* State shared by the threads of one search */
+typedef  struct {
+	graph_t		*G;
+	int			LSource;
+	int			Threads;
+	double		Delta;			//Bucket width
+	double		*Dist;
+	int			*Pred;
+	int			*Taken;			//Round in which each vertex was taken from its bucket
+	int			*Queued;		//Pass in which each vertex was last put in the frontier
+	int			*Frontier;		//Vertices of the bucket, at most one of each
+	int			FrontCount;
+	int			Next;			//Next frontier entry to hand out, taken atomically
+	long long	Bucket;			//Bucket being emptied, LLONG_MAX once all are
+	int			Round;			//Buckets emptied so far, counting from 1
+	int			Pass;			//Frontiers built so far, counting from 1
+	struct DeltaWorker *Workers;
+	pthread_barrier_t Barrier;
+} DeltaJob;
+
+/* Each thread's buckets.  While bucket b is less than DELTA_BINS past the
+ * current one it is Bin[b % DELTA_BINS]; later ones wait in Over. */
+typedef  struct DeltaWorker {
+	DeltaJob	*Job;
+	int			Id;				//0 for the calling thread
+	DeltaList	Bin[DELTA_BINS];
+	DeltaList	Over;
+	long long	OverLow;		//No vertex in Over is in a lower bucket
+	DeltaList	Settled;		//Vertices taken from the current bucket
+	long long	Low;			//Lowest bucket this thread holds, for the reductions
+	int			Unresolved;		//Reached vertices left without a predecessor
+	pthread_t	Thread;
+} DeltaWorker;
+
+
+static int CompareWeights(const void *a, const void *b)
+{
+	double x = *(const double *) a, y = *(const double *) b;
+
+	return (x > y) - (x < y);
+}
+
+/* Picks the bucket width from a sample of the edge weights: DELTA_DEGREE
+ * median weights, divided by the average out-degree.  Wider buckets mean
+ * fewer rounds for the threads to wait on each other, but more costs that
+ * are lowered again before the bucket is done.  Removed edges stay in the
+ * CSR arrays until the next graph_finalize, so the degree only counts the
+ * share of the sample that is still there.
+ */
+double graph_delta_width(graph_t *G)
+{
+	int e, Step, Count, Looked, Edges;
+	double Median, Degree, *Sample;
+
+	if(G->DeltaWidth >= 0) return G->DeltaWidth;
+	graph_finalize(G);
+
+	Edges = G->EdgeOffset[G->NumVert];
+	Sample = (double *) malloc(DELTA_SAMPLE * sizeof(double));
+	Step = Edges / DELTA_SAMPLE + 1;
+	for(e = 0, Count = 0, Looked = 0; e < Edges && Count < DELTA_SAMPLE; e += Step, Looked++)
+		if(G->EdgeWeight[e] != FLT_MAX) Sample[Count++] = G->EdgeWeight[e];
+	qsort(Sample, Count, sizeof(double), CompareWeights);
+	Median = (Count > 0) ? Sample[Count / 2] : 0;
+	free(Sample);
+
+	Degree = (G->NumVert > 0 && Looked > 0) ? (double) Edges * Count / Looked / G->NumVert : 0;
+	if(Degree < 1) Degree = 1;
+	G->DeltaWidth = (Median > 0) ? DELTA_DEGREE * Median / Degree : 1;
+	return G->DeltaWidth;
+}
+
+/* Adds v to the end of L */
+static void ListAdd(DeltaList *L, int v)
+{
+	if(L->Count == L->Size)
+	{
+		COUNT(BytesAllocated, (L->Size == 0 ? 64 : L->Size) * sizeof(int));
+		L->Size = (L->Size == 0) ? 64 : 2 * L->Size;
+		L->Item = (int *) realloc(L->Item, L->Size * sizeof(int));
+		if(L->Item == NULL)
+		{
+			printf("Failed to grow a delta-stepping bucket!\n");
+			exit(1);
+		}
+	}
+	L->Item[L->Count++] = v;
+}
+
+/* Bucket holding the cost Cost */
+static long long BucketOf(DeltaJob *J, double Cost)
+{
+	double b = Cost / J->Delta;
+
+	return (b < DELTA_LAST_BUCKET) ? (long long) b : (long long) DELTA_LAST_BUCKET;
+}
+
+/* Waits for every thread of the search to get here */
+static void DeltaWait(DeltaJob *J)
+{
+	if(J->Threads > 1) pthread_barrier_wait(&J->Barrier);
+}
+
+/* Puts v, now at a cost of Cost, in its bucket */
+static void DeltaPush(DeltaWorker *W, int v, double Cost)
+{
+	long long b = BucketOf(W->Job, Cost);
+
+	if(b < W->Job->Bucket + DELTA_BINS) ListAdd(&W->Bin[b % DELTA_BINS], v);
+	else
+	{
+		ListAdd(&W->Over, v);
+		if(b < W->OverLow) W->OverLow = b;
+	}
+}
+
+/* Lowers the costs of the neighbors of v through its light edges, those no
+ * heavier than the bucket width, or through its heavy ones */
+static void DeltaRelax(DeltaWorker *W, int v, int Heavy)
+{
+	DeltaJob *J = W->Job;
+	graph_t *G = J->G;
+	int e, u;
+	double Cost, Old, New;
+
+	__atomic_load(&J->Dist[v], &Cost, __ATOMIC_RELAXED);
+	COUNT(EdgesScanned, G->EdgeOffset[v+1] - G->EdgeOffset[v]);
+	for(e = G->EdgeOffset[v]; e < G->EdgeOffset[v+1]; e++)
+	{
+		if(G->EdgeWeight[e] == FLT_MAX || (G->EdgeWeight[e] > J->Delta) != Heavy) continue;
+
+		u = G->EdgeTarget[e];
+		New = Cost + G->EdgeWeight[e];
+		__atomic_load(&J->Dist[u], &Old, __ATOMIC_RELAXED);
+		while(New < Old)
+		{
+			//A failed swap leaves the cost another thread set in Old
+			if(__atomic_compare_exchange(&J->Dist[u], &Old, &New, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				COUNT(Relaxations, 1);
+				DeltaPush(W, u, New);
+				break;
+			}
+		}
+	}
+}
+
+/* Gathers the vertices the threads hold for the current bucket into the
+ * frontier, leaving out those whose cost has since dropped into a bucket
+ * already emptied and any already gathered by another thread
+ */
+static void DeltaCollect(DeltaWorker *W)
+{
+	DeltaJob *J = W->Job;
+	DeltaList *B = &W->Bin[J->Bucket % DELTA_BINS];
+	int i, t, v, Keep, Offset, Total;
+	double Cost;
+
+	DeltaWait(J);							//Everyone is done with the last frontier
+	for(i = 0, Keep = 0; i < B->Count; i++)
+	{
+		v = B->Item[i];
+		__atomic_load(&J->Dist[v], &Cost, __ATOMIC_RELAXED);
+		if(BucketOf(J, Cost) == J->Bucket && __atomic_exchange_n(&J->Queued[v], J->Pass, __ATOMIC_RELAXED) != J->Pass)
+			B->Item[Keep++] = v;
+	}
+	B->Count = Keep;
+	DeltaWait(J);
+
+	/* Each thread's part follows those of the threads numbered below it */
+	for(t = 0, Offset = 0, Total = 0; t < J->Threads; t++)
+	{
+		if(t == W->Id) Offset = Total;
+		Total += J->Workers[t].Bin[J->Bucket % DELTA_BINS].Count;
+	}
+	if(B->Count > 0) memcpy(J->Frontier + Offset, B->Item, B->Count * sizeof(int));
+	if(W->Id == 0)
+	{
+		J->FrontCount = Total;
+		J->Next = 0;
+		J->Pass++;
+	}
+	DeltaWait(J);
+	B->Count = 0;
+}
+
+/* Moves on to the lowest bucket any thread holds, bringing the vertices of
+ * Over that are now in reach into the bins */
+static void DeltaNext(DeltaWorker *W)
+{
+	DeltaJob *J = W->Job;
+	int i, t, v, Keep;
+	long long b;
+	double Cost;
+
+	W->Low = W->OverLow;
+	for(b = J->Bucket + 1; b < J->Bucket + DELTA_BINS && b < W->Low; b++)
+		if(W->Bin[b % DELTA_BINS].Count > 0) W->Low = b;
+	DeltaWait(J);
+
+	if(W->Id == 0)
+	{
+		J->Bucket = LLONG_MAX;
+		for(t = 0; t < J->Threads; t++)
+			if(J->Workers[t].Low < J->Bucket) J->Bucket = J->Workers[t].Low;
+		J->Round++;
+	}
+	DeltaWait(J);
+
+	if(J->Bucket == LLONG_MAX || W->OverLow >= J->Bucket + DELTA_BINS) return;
+	W->OverLow = LLONG_MAX;
+	for(i = 0, Keep = 0; i < W->Over.Count; i++)
+	{
+		v = W->Over.Item[i];
+		__atomic_load(&J->Dist[v], &Cost, __ATOMIC_RELAXED);
+		b = BucketOf(J, Cost);
+		if(b < J->Bucket) continue;			//Lowered into a bucket already emptied
+		if(b < J->Bucket + DELTA_BINS) ListAdd(&W->Bin[b % DELTA_BINS], v);
+		else
+		{
+			W->Over.Item[Keep++] = v;
+			if(b < W->OverLow) W->OverLow = b;
+		}
+	}
+	W->Over.Count = Keep;
+}
+
+/* Runs one thread of the search */
+static void* DeltaThread(void *Arg)
+{
+	DeltaWorker *W = (DeltaWorker *) Arg;
+	DeltaJob *J = W->Job;
+	graph_t *G = J->G;
+	int i, v, e, u, Old, First, Last, End;
+
+	/* Each thread starts its own share of the arrays */
+	First = (long long) G->NumVert * W->Id / J->Threads;
+	Last = (long long) G->NumVert * (W->Id + 1) / J->Threads;
+	for(v = First; v < Last; v++)
+	{
+		J->Dist[v] = FLT_MAX;
+		J->Pred[v] = INT_MAX;
+		J->Taken[v] = 0;
+		J->Queued[v] = 0;
+	}
+	DeltaWait(J);
+	if(W->Id == 0)
+	{
+		J->Dist[J->LSource] = 0;
+		DeltaPush(W, J->LSource, 0);
+	}
+
+	while(J->Bucket != LLONG_MAX)
+	{
+		/* Follow the light edges of the bucket until nothing more lands in it */
+		for(;;)
+		{
+			DeltaCollect(W);
+			if(J->FrontCount == 0) break;
+			while((i = __atomic_fetch_add(&J->Next, DELTA_CHUNK, __ATOMIC_RELAXED)) < J->FrontCount)
+			{
+				End = (i + DELTA_CHUNK < J->FrontCount) ? i + DELTA_CHUNK : J->FrontCount;
+				for(; i < End; i++)
+				{
+					v = J->Frontier[i];
+					if(__atomic_exchange_n(&J->Taken[v], J->Round, __ATOMIC_RELAXED) != J->Round)
+					{
+						ListAdd(&W->Settled, v);
+						COUNT(Settled, 1);
+					}
+					DeltaRelax(W, v, FALSE);
+				}
+			}
+		}
+
+		/* The costs in the bucket are final, and its heavy edges lead past it */
+		for(i = 0; i < W->Settled.Count; i++)
+			DeltaRelax(W, W->Settled.Item[i], TRUE);
+		W->Settled.Count = 0;
+		DeltaNext(W);
+	}
+
+	/* The predecessor of each vertex is the lowest numbered one that reaches
+	 * it at its cost from a lower cost */
+	for(v = First; v < Last; v++)
+	{
+		if(J->Dist[v] == FLT_MAX) continue;
+		for(e = G->EdgeOffset[v]; e < G->EdgeOffset[v+1]; e++)
+		{
+			u = G->EdgeTarget[e];
+			if(G->EdgeWeight[e] == FLT_MAX || !(J->Dist[v] < J->Dist[u])
+				|| J->Dist[v] + G->EdgeWeight[e] != J->Dist[u]) continue;
+			Old = __atomic_load_n(&J->Pred[u], __ATOMIC_RELAXED);
+			while(v < Old && !__atomic_compare_exchange_n(&J->Pred[u], &Old, v, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				;
+		}
+	}
+	DeltaWait(J);
+
+	W->Unresolved = 0;
+	for(v = First; v < Last; v++)
+	{
+		if(v == J->LSource || J->Dist[v] == FLT_MAX) J->Pred[v] = v;
+		else if(J->Pred[v] == INT_MAX) W->Unresolved++;
+	}
+
+	if(W->Id > 0) counters_flush();
+	return NULL;
+}
+
+/* Gives a predecessor to the reached vertices left without one.  Each has the
+ * same cost as a neighbor that reaches it, over an edge of weight 0 or one too
+ * light to change the sum, so they are found by a breadth-first search over
+ * such edges from the vertices that have one.
+ */
+static void DeltaTies(graph_t *G, int *Pred, double *ShDis)
+{
+	int u, v, e, Head, Tail, *Queue;
+
+	Queue = (int *) malloc(G->NumVert * sizeof(int));
+	Head = Tail = 0;
+	for(v = 0; v < G->NumVert; v++)
+		if(Pred[v] != INT_MAX) Queue[Tail++] = v;
+
+	while(Head < Tail)
+	{
+		u = Queue[Head++];
+		if(ShDis[u] == FLT_MAX) continue;
+		for(e = G->EdgeOffset[u]; e < G->EdgeOffset[u+1]; e++)
+		{
+			v = G->EdgeTarget[e];
+			if(Pred[v] == INT_MAX && G->EdgeWeight[e] != FLT_MAX && ShDis[u] + G->EdgeWeight[e] == ShDis[v])
+			{
+				Pred[v] = u;
+				Queue[Tail++] = v;
+			}
+		}
+	}
+	free(Queue);
+}
+
+/* A vertex and its cost, for ordering the trace */
+typedef  struct {
+	double	Cost;
+	int		Vertex;
+} DeltaStep;
+
+static int CompareSteps(const void *a, const void *b)
+{
+	const DeltaStep *x = (const DeltaStep *) a, *y = (const DeltaStep *) b;
+
+	if(x->Cost != y->Cost) return (x->Cost < y->Cost) ? -1 : 1;
+	return x->Vertex - y->Vertex;
+}
+
+/* Records the search in the trace as if the reached vertices had been
+ * confirmed one at a time in order of cost.  The lowered costs aren't
+ * recorded, as the threads lower many of them more than once. */
+static void DeltaTrace(graph_t *G, int LSource, int *Pred, double *ShDis)
+{
+	int v, Count;
+	DeltaStep *Steps;
+
+	Steps = (DeltaStep *) malloc(G->NumVert * sizeof(DeltaStep));
+	for(v = 0, Count = 0; v < G->NumVert; v++)
+	{
+		if(v == LSource || ShDis[v] == FLT_MAX) continue;
+		Steps[Count].Cost = ShDis[v];
+		Steps[Count].Vertex = v;
+		Count++;
+	}
+	qsort(Steps, Count, sizeof(DeltaStep), CompareSteps);
+
+	trace_event(TRACE_START, TRACE_ONE_WAY, LSource, -1, 0, 0);
+	for(v = 0; v < Count; v++)
+		trace_event(TRACE_SETTLE, TRACE_ONE_WAY, Steps[v].Vertex, Pred[Steps[v].Vertex], v + 2, Steps[v].Cost);
+	trace_event(TRACE_DONE, TRACE_ONE_WAY, -1, -1, Count + 1, 0);
+	free(Steps);
+}
+
+/* Finds the shortest paths from LSource with Threads threads (0 for one per
+ * processor), leaving the costs in ShDis and the predecessors in Pred.  The
+ * graph must be finalized, and a vertex that can't be reached has a cost of
+ * FLT_MAX and itself as its predecessor.
+ */
+void delta_search(graph_t *G, int LSource, int Threads, int Verbose, int *Pred, double *ShDis)
+{
+	int t, b, Unresolved;
+	DeltaJob Job;
+	DeltaWorker *Workers;
+
+	Threads = apsp_thread_count(Threads);
+	if(Threads > G->NumVert / DELTA_SHARE) Threads = G->NumVert / DELTA_SHARE;
+	if(Threads < 1) Threads = 1;
+
+	Job.G = G;
+	Job.LSource = LSource;
+	Job.Threads = Threads;
+	Job.Delta = graph_delta_width(G);
+	Job.Dist = ShDis;
+	Job.Pred = Pred;
+	Job.Taken = (int *) malloc(G->NumVert * sizeof(int));
+	Job.Queued = (int *) malloc(G->NumVert * sizeof(int));
+	Job.Frontier = (int *) malloc((G->NumVert + 1) * sizeof(int));
+	Job.FrontCount = 0;
+	Job.Next = 0;
+	Job.Bucket = 0;
+	Job.Round = 1;
+	Job.Pass = 1;
+	COUNT(BytesAllocated, G->NumVert * 3 * sizeof(int));
+	if(Threads > 1) pthread_barrier_init(&Job.Barrier, NULL, Threads);
+
+	Workers = (DeltaWorker *) calloc(Threads, sizeof(DeltaWorker));
+	Job.Workers = Workers;
+	for(t = 0; t < Threads; t++)
+	{
+		Workers[t].Job = &Job;
+		Workers[t].Id = t;
+		Workers[t].OverLow = LLONG_MAX;
+	}
+
+	/* The calling thread works as worker 0 */
+	for(t = 1; t < Threads; t++)
+	{
+		if(pthread_create(&Workers[t].Thread, NULL, DeltaThread, &Workers[t]) != 0)
+		{
+			fprintf(stderr, "Failed to start thread %d\n", t);
+			exit(1);
+		}
+	}
+	DeltaThread(&Workers[0]);
+	for(t = 1; t < Threads; t++)
+		pthread_join(Workers[t].Thread, NULL);
+
+	Unresolved = 0;
+	for(t = 0; t < Threads; t++)
+	{
+		Unresolved += Workers[t].Unresolved;
+		for(b = 0; b < DELTA_BINS; b++) free(Workers[t].Bin[b].Item);
+		free(Workers[t].Over.Item);
+		free(Workers[t].Settled.Item);
+	}
+	if(Unresolved > 0) DeltaTies(G, Pred, ShDis);
+	if(Verbose) DeltaTrace(G, LSource, Pred, ShDis);
+
+	if(Threads > 1) pthread_barrier_destroy(&Job.Barrier);
+	free(Workers);
+	free(Job.Taken);
+	free(Job.Queued);
+	free(Job.Frontier);
+}
@@ -0,0 +1,19 @@
+/* delta.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * Single source shortest paths by delta-stepping, with the work of each
+ * bucket of costs shared between a pool of threads.  Include graph.h before
+ * this file.
+ */
+
+#define DELTA_BINS 256			//Buckets each thread keeps ahead of the current one
+#define DELTA_CHUNK 64			//Frontier vertices a thread takes at a time
+#define DELTA_SHARE 4096		//Fewest vertices worth giving to each thread
+#define DELTA_SAMPLE 4096		//Edge weights looked at to pick the bucket width
+#define DELTA_DEGREE 4.0		//Bucket width times the average out-degree, in median weights
+
+double graph_delta_width(graph_t *G);
+void delta_search(graph_t *G, int LSource, int Threads, int Verbose, int *Pred, double *ShDis);
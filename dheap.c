@@ -0,0 +1,158 @@
+/* dheap.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * An implicit d-ary heap.  The children of position i are D*i+1 .. D*i+D, so
+ * with 4 or 8 children a node's children share one or two cache lines and the
+ * heap is half or a third as tall as a binary heap.  Like heap2.c, the position
+ * of each vertex is kept so a lower key moves the existing entry up.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include "heap.h"
+#include "pqueue.h"
+#include "counters.h"
+
+typedef  struct {
+    int      D;                    /* children per node */
+    int      Count;
+    int      MaxCount;
+    int      NumVertices;
+    PQItem   *ItemArray;           /* NumVertices entries, starting at 0 */
+    int      *ItemLocation;        /* position of each vertex, -1 if absent */
+} DHeap;
+
+/*--------------------------------------------------*/
+
+static DHeap *DHeapInitialize(int num_vertices, int D)
+{
+    int i;
+    DHeap *H;
+    H = (DHeap *) malloc(sizeof(DHeap));
+    H->D = D;
+    H->Count = 0;
+    H->MaxCount = 0;
+    H->NumVertices = num_vertices;
+    H->ItemArray = (PQItem *) malloc(num_vertices * sizeof(PQItem));
+    H->ItemLocation = (int *) malloc(num_vertices * sizeof(int));
+    for (i = 0; i < num_vertices; i++) H->ItemLocation[i] = -1;
+    COUNT(BytesAllocated, sizeof(DHeap) + num_vertices * (sizeof(PQItem) + sizeof(int)));
+    return H;
+}
+static void *DHeap4Initialize(int num_vertices)
+{
+    return DHeapInitialize(num_vertices, 4);
+}
+static void *DHeap8Initialize(int num_vertices)
+{
+    return DHeapInitialize(num_vertices, 8);
+}
+static void DHeapDestruct(void *Q)
+{
+    DHeap *H = (DHeap *) Q;
+    COUNT_PEAK(H->MaxCount);
+    free(H->ItemArray);
+    free(H->ItemLocation);
+    free(H);
+}
+
+/*--------------------------------------------------*/
+static int DHeapEmpty(void *Q)
+{
+    return (((DHeap *) Q)->Count == 0);
+}
+
+/*--------------------------------------------------*/
+
+static void DHeapInsert(PQItem Item, void *Q)
+{
+    DHeap *H = (DHeap *) Q;
+    int  ChildLoc;                         /* location of current child */
+    int  ParentLoc;                          /* parent of current child */
+
+    assert(Item.node >= 0 && Item.node < H->NumVertices);
+
+    // If the Item is already in heap then update
+    if (H->ItemLocation[Item.node] >= 0) {
+        ChildLoc = H->ItemLocation[Item.node];
+        COUNT(DecreaseKeys, 1);
+    }
+    else {
+        COUNT(Inserts, 1);
+        ChildLoc = H->Count;
+        (H->Count)++;
+        if (H->Count > H->MaxCount) H->MaxCount = H->Count;
+    }
+
+    /* Move parents down until Item fits */
+    while (ChildLoc > 0) {
+        ParentLoc = (ChildLoc - 1) / H->D;
+        if (Item.weight >= H->ItemArray[ParentLoc].weight) break;
+        H->ItemArray[ChildLoc] = H->ItemArray[ParentLoc];
+        H->ItemLocation[H->ItemArray[ChildLoc].node] = ChildLoc;
+        ChildLoc = ParentLoc;
+    }
+
+    H->ItemArray[ChildLoc] = Item;
+    H->ItemLocation[Item.node] = ChildLoc;
+}
+
+/*--------------------------------------------------*/
+
+static PQItem DHeapRemove(void *Q)
+{
+    DHeap *H = (DHeap *) Q;
+    int     CurrentLoc;            /* location currently being examined */
+    int     ChildLoc;                        /* smallest child of CurrentLoc */
+    int     FirstChild, LastChild, i;
+    PQItem  ItemToPlace;                   /* an Item value to relocate */
+    PQItem  ItemToReturn;           /* the removed Item value to return */
+
+    if (DHeapEmpty(Q))        /* result is undefined if the heap was empty */
+    {
+        printf("Attempting to remove from empty d-ary heap\n");
+        exit(1);
+    }
+
+    COUNT(Removes, 1);
+    ItemToReturn = H->ItemArray[0];
+    H->ItemLocation[ItemToReturn.node] = -1;
+    (H->Count)--;
+    if (H->Count == 0) return ItemToReturn;
+
+    /* Sift the last leaf down from the root */
+    ItemToPlace = H->ItemArray[H->Count];
+    CurrentLoc = 0;
+    for (;;) {
+        FirstChild = H->D * CurrentLoc + 1;
+        if (FirstChild >= H->Count) break;
+        LastChild = FirstChild + H->D;
+        if (LastChild > H->Count) LastChild = H->Count;
+
+        ChildLoc = FirstChild;
+        for (i = FirstChild + 1; i < LastChild; i++)
+            if (H->ItemArray[i].weight < H->ItemArray[ChildLoc].weight) ChildLoc = i;
+
+        if (H->ItemArray[ChildLoc].weight >= ItemToPlace.weight) break;
+        H->ItemArray[CurrentLoc] = H->ItemArray[ChildLoc];
+        H->ItemLocation[H->ItemArray[CurrentLoc].node] = CurrentLoc;
+        CurrentLoc = ChildLoc;
+    }
+
+    H->ItemArray[CurrentLoc] = ItemToPlace;
+    H->ItemLocation[ItemToPlace.node] = CurrentLoc;
+    return ItemToReturn;
+}
+
+/*--------------------------------------------------*/
+
+const PQOps PQDHeap4 = {
+    "4-ary", DHeap4Initialize, DHeapDestruct, DHeapEmpty, DHeapInsert, DHeapRemove
+};
+const PQOps PQDHeap8 = {
+    "8-ary", DHeap8Initialize, DHeapDestruct, DHeapEmpty, DHeapInsert, DHeapRemove
+};
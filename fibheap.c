@@ -0,0 +1,241 @@
+/* fibheap.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * A Fibonacci heap.  Each vertex has one node, stored in an array indexed by
+ * the vertex, on a circular list of roots or of siblings.  Lowering a key cuts
+ * the node to the root list in O(1) amortized time, with the cascading cuts
+ * of marked parents.  Removing the minimum links roots of equal degree until
+ * every root has a different degree.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include "heap.h"
+#include "pqueue.h"
+#include "counters.h"
+
+#define FIB_MAX_DEGREE 64
+
+typedef  struct {
+    double   weight;
+    int      Parent;
+    int      Child;                /* any one child, -1 if none */
+    int      Left, Right;          /* circular list of siblings */
+    int      Degree;
+    int      Mark;                 /* lost a child since it became a child */
+    int      InHeap;
+} FibNode;
+
+typedef  struct {
+    int      Min;                  /* root with the smallest key */
+    int      Count;
+    int      MaxCount;
+    int      NumVertices;
+    FibNode  *Node;
+    int      *Roots;               /* scratch list for consolidating */
+} FibHeap;
+
+/*--------------------------------------------------*/
+
+/* Puts x on the circular list next to y */
+static void FibSplice(FibNode *N, int x, int y)
+{
+    N[x].Left = y;
+    N[x].Right = N[y].Right;
+    N[N[y].Right].Left = x;
+    N[y].Right = x;
+}
+
+/* Takes x off whichever circular list it is on */
+static void FibUnlink(FibNode *N, int x)
+{
+    N[N[x].Left].Right = N[x].Right;
+    N[N[x].Right].Left = N[x].Left;
+    N[x].Left = N[x].Right = x;
+}
+
+/* Moves x from the children of its parent p to the root list */
+static void FibCut(FibHeap *H, int x, int p)
+{
+    FibNode *N = H->Node;
+
+    if (N[p].Child == x) N[p].Child = (N[x].Right == x) ? -1 : N[x].Right;
+    FibUnlink(N, x);
+    N[p].Degree--;
+    FibSplice(N, x, H->Min);
+    N[x].Parent = -1;
+    N[x].Mark = 0;
+}
+
+/* Makes root y a child of root x */
+static void FibLink(FibHeap *H, int y, int x)
+{
+    FibNode *N = H->Node;
+
+    FibUnlink(N, y);
+    if (N[x].Child < 0) N[x].Child = y;
+    else FibSplice(N, y, N[x].Child);
+    N[y].Parent = x;
+    N[y].Mark = 0;
+    N[x].Degree++;
+}
+
+/*--------------------------------------------------*/
+
+static void *FibInitialize(int num_vertices)
+{
+    int i;
+    FibHeap *H;
+    H = (FibHeap *) malloc(sizeof(FibHeap));
+    H->Min = -1;
+    H->Count = 0;
+    H->MaxCount = 0;
+    H->NumVertices = num_vertices;
+    H->Node = (FibNode *) malloc(num_vertices * sizeof(FibNode));
+    H->Roots = (int *) malloc(num_vertices * sizeof(int));
+    for (i = 0; i < num_vertices; i++) H->Node[i].InHeap = 0;
+    COUNT(BytesAllocated, sizeof(FibHeap) + num_vertices * (sizeof(FibNode) + sizeof(int)));
+    return H;
+}
+static void FibDestruct(void *Q)
+{
+    FibHeap *H = (FibHeap *) Q;
+    COUNT_PEAK(H->MaxCount);
+    free(H->Node);
+    free(H->Roots);
+    free(H);
+}
+
+/*--------------------------------------------------*/
+static int FibEmpty(void *Q)
+{
+    return (((FibHeap *) Q)->Count == 0);
+}
+
+/*--------------------------------------------------*/
+
+static void FibInsert(PQItem Item, void *Q)
+{
+    FibHeap *H = (FibHeap *) Q;
+    FibNode *N = H->Node;
+    int x = Item.node, p;
+
+    assert(x >= 0 && x < H->NumVertices);
+
+    if (N[x].InHeap) {
+        /* Lower the key, cutting x and any marked parents above it */
+        COUNT(DecreaseKeys, 1);
+        N[x].weight = Item.weight;
+        p = N[x].Parent;
+        if (p >= 0 && N[x].weight < N[p].weight) {
+            FibCut(H, x, p);
+            while (N[p].Parent >= 0) {
+                if (!N[p].Mark) {
+                    N[p].Mark = 1;
+                    break;
+                }
+                x = N[p].Parent;
+                FibCut(H, p, x);
+                p = x;
+            }
+            x = Item.node;
+        }
+    }
+    else {
+        COUNT(Inserts, 1);
+        N[x].weight = Item.weight;
+        N[x].Parent = N[x].Child = -1;
+        N[x].Left = N[x].Right = x;
+        N[x].Degree = 0;
+        N[x].Mark = 0;
+        N[x].InHeap = 1;
+        if (H->Min >= 0) FibSplice(N, x, H->Min);
+        (H->Count)++;
+        if (H->Count > H->MaxCount) H->MaxCount = H->Count;
+    }
+
+    if (H->Min < 0 || N[x].weight < N[H->Min].weight) H->Min = x;
+}
+
+/*--------------------------------------------------*/
+
+static PQItem FibRemove(void *Q)
+{
+    FibHeap *H = (FibHeap *) Q;
+    FibNode *N = H->Node;
+    int z, c, x, y, t, d, i, n;
+    int Degree[FIB_MAX_DEGREE];
+    PQItem ItemToReturn;
+
+    if (FibEmpty(Q))        /* result is undefined if the heap was empty */
+    {
+        printf("Attempting to remove from empty Fibonacci heap\n");
+        exit(1);
+    }
+
+    COUNT(Removes, 1);
+    z = H->Min;
+    ItemToReturn.node = z;
+    ItemToReturn.weight = N[z].weight;
+    N[z].InHeap = 0;
+    (H->Count)--;
+
+    /* The children of z become roots */
+    while ((c = N[z].Child) >= 0) {
+        N[z].Child = (N[c].Right == c) ? -1 : N[c].Right;
+        FibUnlink(N, c);
+        FibSplice(N, c, z);
+        N[c].Parent = -1;
+    }
+
+    if (N[z].Right == z) {
+        H->Min = -1;
+        return ItemToReturn;
+    }
+    x = N[z].Right;
+    FibUnlink(N, z);
+
+    /* Copy the root list, since linking changes it */
+    n = 0;
+    t = x;
+    do {
+        H->Roots[n++] = t;
+        t = N[t].Right;
+    } while (t != x);
+
+    /* Link roots of the same degree until the degrees are all different */
+    for (d = 0; d < FIB_MAX_DEGREE; d++) Degree[d] = -1;
+    for (i = 0; i < n; i++) {
+        x = H->Roots[i];
+        d = N[x].Degree;
+        while (Degree[d] >= 0) {
+            y = Degree[d];
+            if (N[y].weight < N[x].weight) {
+                t = x; x = y; y = t;
+            }
+            FibLink(H, y, x);
+            Degree[d] = -1;
+            d++;
+        }
+        Degree[d] = x;
+    }
+
+    /* The new minimum is one of the remaining roots */
+    H->Min = -1;
+    for (d = 0; d < FIB_MAX_DEGREE; d++) {
+        if (Degree[d] >= 0 && (H->Min < 0 || N[Degree[d]].weight < N[H->Min].weight))
+            H->Min = Degree[d];
+    }
+
+    return ItemToReturn;
+}
+
+/*--------------------------------------------------*/
+
+const PQOps PQFibonacci = {
+    "Fibonacci", FibInitialize, FibDestruct, FibEmpty, FibInsert, FibRemove
+};
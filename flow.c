@@ -0,0 +1,442 @@
+/* flow.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * This file finds the largest set of link-disjoint paths between two
+ * vertices with Dinic's maximum flow algorithm.  Every edge has a capacity of
+ * one, so a flow of k is k paths that share no edge.  Each phase labels the
+ * vertices by their distance from the source in the residual graph, then
+ * pushes paths along edges that go one label up until none are left.  The
+ * residual edges of u are its out-edges without flow, followed by its
+ * in-edges with flow, which are taken backward to cancel that flow.
+ *
+ * The K cheapest link-disjoint paths in total come from the same residual
+ * graph, by adding one cheapest path at a time to the flow (successive
+ * shortest paths).
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <float.h>
+
+#include "graph.h"
+#include "heap.h"
+#include "pqueue.h"
+#include "flow.h"
+
+/* The graph seen by the flow algorithm.  The in-edges of v are the entries
+ * InOffset[v] .. InOffset[v+1]-1 of InEdge, the CSR index of each edge, and
+ * InFrom, the vertex it comes from.
+ */
+typedef  struct {
+	graph_t	*G;
+	int		*InOffset;
+	int		*InEdge;
+	int		*InFrom;
+	char	*Flow;					//Flow on each CSR edge, 0 or 1
+	int		*Level;					//Distance from the source, -1 if not reached;
+									//FlowCheapest marks confirmed vertices in it
+	int		*Queue;
+} FlowGraph;
+
+/* Labels every vertex with its residual distance from LSource.  Returns TRUE
+ * if LDest was reached.
+ */
+static int FlowLevels(FlowGraph *F, int LSource, int LDest)
+{
+	int u, v, e, i, Head = 0, Tail = 0;
+	graph_t *G = F->G;
+
+	for(u = 0; u < G->NumVert; u++) F->Level[u] = -1;
+	F->Level[LSource] = 0;
+	F->Queue[Tail++] = LSource;
+
+	while(Head < Tail)
+	{
+		u = F->Queue[Head++];
+		for(e = G->EdgeOffset[u]; e < G->EdgeOffset[u+1]; e++)
+		{
+			v = G->EdgeTarget[e];
+			if(F->Flow[e] || G->EdgeWeight[e] == FLT_MAX || F->Level[v] >= 0) continue;
+			F->Level[v] = F->Level[u] + 1;
+			F->Queue[Tail++] = v;
+		}
+		for(i = F->InOffset[u]; i < F->InOffset[u+1]; i++)
+		{
+			v = F->InFrom[i];
+			if(!F->Flow[F->InEdge[i]] || F->Level[v] >= 0) continue;
+			F->Level[v] = F->Level[u] + 1;
+			F->Queue[Tail++] = v;
+		}
+	}
+	return F->Level[LDest] >= 0;
+}
+
+/* Pushes paths from LSource to LDest along edges that go one level up, until
+ * there are none.  Cur[u] is the next residual edge of u to try; edges that
+ * lead nowhere are passed over for the rest of the phase.  The path is kept
+ * on a stack instead of by recursion, since it can be NumVert long.  Returns
+ * the number of paths pushed.
+ */
+static int FlowBlock(FlowGraph *F, int LSource, int LDest, int *Cur, int *Path, int *Arc)
+{
+	int u, v, e, a, Out, Top, Pushed = 0;
+	graph_t *G = F->G;
+
+	for(u = 0; u < G->NumVert; u++) Cur[u] = 0;
+
+	Top = 0;
+	Path[0] = LSource;
+	while(TRUE)
+	{
+		u = Path[Top];
+		if(u == LDest)
+		{
+			/* Flip the flow on every edge of the path, then start over */
+			for(a = 0; a < Top; a++)
+			{
+				if(Arc[a] >= 0) F->Flow[Arc[a]] = 1;
+				else F->Flow[-Arc[a]-1] = 0;
+			}
+			Pushed++;
+			Top = 0;
+			continue;
+		}
+
+		/* Find the next residual edge of u that goes one level up */
+		Out = G->EdgeOffset[u+1] - G->EdgeOffset[u];
+		v = -1;
+		for(; Cur[u] < Out + F->InOffset[u+1] - F->InOffset[u]; Cur[u]++)
+		{
+			if(Cur[u] < Out)
+			{
+				e = G->EdgeOffset[u] + Cur[u];
+				if(F->Flow[e] || G->EdgeWeight[e] == FLT_MAX) continue;
+				v = G->EdgeTarget[e];
+				Arc[Top] = e;
+			}
+			else
+			{
+				a = F->InOffset[u] + Cur[u] - Out;
+				if(!F->Flow[F->InEdge[a]]) continue;
+				v = F->InFrom[a];
+				Arc[Top] = -F->InEdge[a]-1;		//Negative for an edge taken backward
+			}
+			if(F->Level[v] == F->Level[u] + 1) break;
+			v = -1;
+		}
+
+		if(v >= 0) Path[++Top] = v;
+		else
+		{
+			/* Nothing more gets through u in this phase */
+			F->Level[u] = -1;
+			if(Top == 0) break;
+			Top--;
+			Cur[Path[Top]]++;
+		}
+	}
+	return Pushed;
+}
+
+/* Follows the flow out of LSource to LDest, using up the flow it follows, to
+ * find the next path into P.  Any loop the flow makes is cut out of the path.
+ * Pos[v] is the place of v on the path so far, -1 if it isn't on it.
+ */
+static void FlowTakePath(FlowGraph *F, int LSource, int LDest, LinkPaths *P, int *Cur, int *Pos, int *Edge)
+{
+	int u, v, e, Len = 0, i, First;
+	graph_t *G = F->G;
+
+	First = P->Start[P->NumPaths];
+	P->Vert[First] = LSource;
+	Pos[LSource] = 0;
+	u = LSource;
+	while(u != LDest)
+	{
+		e = Cur[u];
+		while(!F->Flow[e]) e++;				//Flow in means flow out, so one is left
+		Cur[u] = e + 1;
+		F->Flow[e] = 0;
+		v = G->EdgeTarget[e];
+
+		if(Pos[v] >= 0)
+		{
+			/* Back on the path: drop the loop */
+			for(i = Pos[v] + 1; i <= Len; i++) Pos[P->Vert[First + i]] = -1;
+			Len = Pos[v];
+		}
+		else
+		{
+			Edge[Len] = e;
+			P->Vert[First + ++Len] = v;
+			Pos[v] = Len;
+		}
+		u = v;
+	}
+
+	P->Cost[P->NumPaths] = 0;
+	for(i = 0; i < Len; i++)
+	{
+		Pos[P->Vert[First + i]] = -1;
+		P->Cost[P->NumPaths] += G->EdgeWeight[Edge[i]];
+	}
+	Pos[LDest] = -1;
+	P->NumPaths++;
+	P->Start[P->NumPaths] = First + Len + 1;
+}
+
+/* Cost of each path, for CompareCost */
+static double *SortCost;
+
+/* Orders path numbers by cost, then by number */
+static int CompareCost(const void *a, const void *b)
+{
+	int i = *(const int *) a, j = *(const int *) b;
+
+	if(SortCost[i] != SortCost[j]) return (SortCost[i] < SortCost[j]) ? -1 : 1;
+	return i - j;
+}
+
+/* Puts the paths of P in order of cost */
+static void SortPaths(LinkPaths *P)
+{
+	int i, k, *Order, *Start, *Vert;
+	double *Cost;
+
+	Order = (int *) malloc((P->NumPaths + 1) * sizeof(int));
+	for(i = 0; i < P->NumPaths; i++) Order[i] = i;
+	SortCost = P->Cost;
+	qsort(Order, P->NumPaths, sizeof(int), CompareCost);
+
+	Start = (int *) malloc((P->NumPaths + 1) * sizeof(int));
+	Vert = (int *) malloc((P->Start[P->NumPaths] + 1) * sizeof(int));
+	Cost = (double *) malloc((P->NumPaths + 1) * sizeof(double));
+	Start[0] = 0;
+	for(i = 0; i < P->NumPaths; i++)
+	{
+		Start[i+1] = Start[i];
+		for(k = P->Start[Order[i]]; k < P->Start[Order[i]+1]; k++)
+			Vert[Start[i+1]++] = P->Vert[k];
+		Cost[i] = P->Cost[Order[i]];
+	}
+
+	free(P->Start); free(P->Vert); free(P->Cost); free(Order);
+	P->Start = Start;
+	P->Vert = Vert;
+	P->Cost = Cost;
+}
+
+/* Sets up F for the edges of G, with no flow yet */
+static void FlowBuild(FlowGraph *F, graph_t *G)
+{
+	int u, e, i, n, *Next;
+
+	graph_finalize(G);
+	n = G->NumVert;
+	F->G = G;
+
+	/* Group the edges by the vertex they go into */
+	F->InOffset = (int *) calloc(n + 1, sizeof(int));
+	F->InEdge = (int *) malloc((G->EdgeOffset[n] + 1) * sizeof(int));
+	F->InFrom = (int *) malloc((G->EdgeOffset[n] + 1) * sizeof(int));
+	for(e = 0; e < G->EdgeOffset[n]; e++)
+		if(G->EdgeWeight[e] != FLT_MAX) F->InOffset[G->EdgeTarget[e] + 1]++;
+	for(u = 0; u < n; u++) F->InOffset[u+1] += F->InOffset[u];
+	Next = (int *) malloc((n + 1) * sizeof(int));
+	for(u = 0; u < n; u++) Next[u] = F->InOffset[u];
+	for(u = 0; u < n; u++)
+	{
+		for(e = G->EdgeOffset[u]; e < G->EdgeOffset[u+1]; e++)
+		{
+			if(G->EdgeWeight[e] == FLT_MAX) continue;
+			i = Next[G->EdgeTarget[e]]++;
+			F->InEdge[i] = e;
+			F->InFrom[i] = u;
+		}
+	}
+	free(Next);
+
+	F->Flow = (char *) calloc(G->EdgeOffset[n] + 1, sizeof(char));
+	F->Level = (int *) malloc(n * sizeof(int));
+	F->Queue = (int *) malloc(n * sizeof(int));
+}
+
+/* Frees the arrays of F */
+static void FlowFree(FlowGraph *F)
+{
+	free(F->InOffset); free(F->InEdge); free(F->InFrom); free(F->Flow);
+	free(F->Level); free(F->Queue);
+}
+
+/* Splits a flow of Paths units from LSource to LDest into paths */
+static LinkPaths* FlowSplit(FlowGraph *F, int LSource, int LDest, int Paths)
+{
+	int u, i, n = F->G->NumVert, *Cur, *Pos, *Edge;
+	LinkPaths *P;
+
+	P = (LinkPaths *) malloc(sizeof(LinkPaths));
+	P->NumPaths = 0;
+	P->Start = (int *) malloc((Paths + 1) * sizeof(int));
+	P->Cost = (double *) malloc((Paths + 1) * sizeof(double));
+	P->Vert = (int *) malloc((F->G->EdgeOffset[n] + Paths + 1) * sizeof(int));
+	P->Start[0] = 0;
+
+	Cur = (int *) malloc(n * sizeof(int));
+	Pos = (int *) malloc(n * sizeof(int));
+	Edge = (int *) malloc((n + 1) * sizeof(int));
+	for(u = 0; u < n; u++) {
+		Cur[u] = F->G->EdgeOffset[u];
+		Pos[u] = -1;
+	}
+	for(i = 0; i < Paths; i++)
+		FlowTakePath(F, LSource, LDest, P, Cur, Pos, Edge);
+	SortPaths(P);
+
+	free(Cur); free(Pos); free(Edge);
+	return P;
+}
+
+/* Finds as many paths from LSource to LDest as possible that share no edge */
+LinkPaths* DisjointPaths(graph_t *G, int LSource, int LDest)
+{
+	int n, Paths = 0, *Cur, *Path, *Arc;
+	FlowGraph F;
+
+	FlowBuild(&F, G);
+	n = G->NumVert;
+	Cur = (int *) malloc((n + 1) * sizeof(int));
+	Path = (int *) malloc((n + 1) * sizeof(int));
+	Arc = (int *) malloc((n + 1) * sizeof(int));
+
+	if(LSource != LDest)
+		while(FlowLevels(&F, LSource, LDest))
+			Paths += FlowBlock(&F, LSource, LDest, Cur, Path, Arc);
+	free(Cur); free(Path); free(Arc);
+
+	LinkPaths *P = FlowSplit(&F, LSource, LDest, Paths);
+	FlowFree(&F);
+	return P;
+}
+
+/* Finds the cheapest residual path from LSource to LDest by Dijkstra's
+ * algorithm on the reduced costs  w(u,v) + Pot[u] - Pot[v],  which are never
+ * negative; an edge taken backward costs -w.  Arc[v] is the residual edge
+ * into v, coded as in FlowBlock.  Afterwards every Pot[v] goes up by the
+ * reduced cost to v, capped at the cost to LDest, which keeps the reduced
+ * costs of the next residual graph from going negative.  From[v] is the
+ * vertex before v on the path.  Returns FALSE if
+ * LDest can't be reached.
+ */
+static int FlowCheapest(FlowGraph *F, int LSource, int LDest, double *Pot, double *Dist, int *Arc, int *From, void *PQ)
+{
+	int u, v, e, i;
+	double Cost, Cap;
+	graph_t *G = F->G;
+	PQItem Item;
+
+	for(u = 0; u < G->NumVert; u++) {
+		Dist[u] = FLT_MAX;
+		F->Level[u] = FALSE;				//TRUE once u is confirmed
+	}
+	Dist[LSource] = 0;
+	Item.node = LSource;
+	Item.weight = 0;
+	PQDHeap4.Insert(Item, PQ);
+
+	while(!PQDHeap4.Empty(PQ))
+	{
+		u = PQDHeap4.Remove(PQ).node;
+		F->Level[u] = TRUE;
+		if(u == LDest) break;
+
+		for(e = G->EdgeOffset[u]; e < G->EdgeOffset[u+1]; e++)
+		{
+			v = G->EdgeTarget[e];
+			if(F->Flow[e] || G->EdgeWeight[e] == FLT_MAX || F->Level[v]) continue;
+			Cost = G->EdgeWeight[e] + Pot[u] - Pot[v];
+			if(Cost < 0) Cost = 0;			//Only rounding can make it negative
+			if(Dist[u] + Cost < Dist[v])
+			{
+				Dist[v] = Dist[u] + Cost;
+				Arc[v] = e;
+				From[v] = u;
+				Item.node = v;
+				Item.weight = Dist[v];
+				PQDHeap4.Insert(Item, PQ);
+			}
+		}
+		for(i = F->InOffset[u]; i < F->InOffset[u+1]; i++)
+		{
+			v = F->InFrom[i];
+			if(!F->Flow[F->InEdge[i]] || F->Level[v]) continue;
+			Cost = -G->EdgeWeight[F->InEdge[i]] + Pot[u] - Pot[v];
+			if(Cost < 0) Cost = 0;
+			if(Dist[u] + Cost < Dist[v])
+			{
+				Dist[v] = Dist[u] + Cost;
+				Arc[v] = -F->InEdge[i]-1;
+				From[v] = u;
+				Item.node = v;
+				Item.weight = Dist[v];
+				PQDHeap4.Insert(Item, PQ);
+			}
+		}
+	}
+	while(!PQDHeap4.Empty(PQ)) PQDHeap4.Remove(PQ);
+
+	if(Dist[LDest] == FLT_MAX) return FALSE;
+	Cap = Dist[LDest];
+	for(u = 0; u < G->NumVert; u++)
+		Pot[u] += (F->Level[u] && Dist[u] < Cap) ? Dist[u] : Cap;
+	return TRUE;
+}
+
+/* Finds K paths from LSource to LDest that share no edge and cost the least
+ * in total, or as many as there are if that is fewer.  Each path found is
+ * added to the flow, then the cheapest path in what is left is found, which
+ * may cancel part of an earlier path by taking its edges backward.  The
+ * potentials carried from one search to the next keep every search a plain
+ * Dijkstra.  With K = 2 this is Suurballe's algorithm.
+ */
+LinkPaths* CheapestDisjointPaths(graph_t *G, int LSource, int LDest, int K)
+{
+	int v, Paths = 0, *Arc, *From;
+	double *Pot, *Dist;
+	void *PQ;
+	FlowGraph F;
+	LinkPaths *P;
+
+	FlowBuild(&F, G);
+	Pot = (double *) calloc(G->NumVert, sizeof(double));		//All zero is fine, no weight is negative
+	Dist = (double *) malloc(G->NumVert * sizeof(double));
+	Arc = (int *) malloc(G->NumVert * sizeof(int));
+	From = (int *) malloc(G->NumVert * sizeof(int));
+	PQ = PQDHeap4.Initialize(G->NumVert);
+
+	while(LSource != LDest && Paths < K && FlowCheapest(&F, LSource, LDest, Pot, Dist, Arc, From, PQ))
+	{
+		/* Push one unit of flow back along the path from LDest */
+		for(v = LDest; v != LSource; v = From[v])
+		{
+			if(Arc[v] >= 0) F.Flow[Arc[v]] = 1;
+			else F.Flow[-Arc[v]-1] = 0;
+		}
+		Paths++;
+	}
+
+	P = FlowSplit(&F, LSource, LDest, Paths);
+	free(Pot); free(Dist); free(Arc); free(From);
+	PQDHeap4.Destruct(PQ);
+	FlowFree(&F);
+	return P;
+}
+
+/* Frees the paths in P */
+void link_paths_free(LinkPaths *P)
+{
+	free(P->Start); free(P->Vert); free(P->Cost);
+	free(P);
+}
@@ -0,0 +1,28 @@
+/* flow.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * Link-disjoint paths between two vertices: the most there can be, by
+ * maximum flow, or the K that cost the least in total, by minimum cost flow.
+ */
+
+/* Methods for the link-disjoint paths, chosen with -m in lab6 */
+#define LINK_GREEDY 1			//Shortest path, remove its links, repeat
+#define LINK_MAX_FLOW 2			//Dinic's maximum flow, split into paths
+#define LINK_REPAIR 3			//Like LINK_GREEDY, repairing the search instead of rerunning it
+
+/* Paths from the source to the destination that share no edge, cheapest
+ * first.  Path i is Vert[Start[i]] .. Vert[Start[i+1]-1], source first.
+ */
+typedef  struct {
+	int		NumPaths;
+	int		*Start;
+	int		*Vert;
+	double	*Cost;
+} LinkPaths;
+
+LinkPaths* DisjointPaths(graph_t *G, int LSource, int LDest);
+LinkPaths* CheapestDisjointPaths(graph_t *G, int LSource, int LDest, int K);
+void link_paths_free(LinkPaths *P);
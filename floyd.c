@@ -0,0 +1,205 @@
+/* floyd.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * This file contains a tiled Floyd-Warshall algorithm.  The matrix is copied
+ * into one aligned block and processed in FLOYD_BLOCK x FLOYD_BLOCK tiles: for
+ * each diagonal tile, first the tile itself, then the tiles in its row and
+ * column, then all the others, so the three tiles in use stay in cache.  The
+ * inner loop is a min-plus update of one tile row, done four (AVX2) or two
+ * (SSE2) columns at a time.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "graph.h"
+#include "floyd.h"
+
+
+/* Relaxes tile (ib, jb) through the vertices of tile kb:
+ *		Dist[i][j] = min(Dist[i][j], Dist[i][k] + Dist[k][j])
+ */
+static void FloydTile(FloydResult *F, int ib, int jb, int kb)
+{
+	int i, j, k, s = F->Stride, nik;
+	double dik, *Dij, *Dkj;
+	int *Nij;
+
+	for(k = kb; k < kb + FLOYD_BLOCK; k++)
+	{
+		Dkj = F->Dist + (size_t) k * s;
+		for(i = ib; i < ib + FLOYD_BLOCK; i++)
+		{
+			dik = F->Dist[(size_t) i * s + k];
+			if(dik == FLT_MAX) continue;				//No path from i through k
+			nik = F->Next[(size_t) i * s + k];
+			Dij = F->Dist + (size_t) i * s;
+			Nij = F->Next + (size_t) i * s;
+
+#if defined(__AVX2__)
+			__m256d vik = _mm256_set1_pd(dik);
+			__m128i vnik = _mm_set1_epi32(nik);
+			__m256i Low = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+			for(j = jb; j < jb + FLOYD_BLOCK; j += 4)
+			{
+				__m256d dij = _mm256_load_pd(Dij + j);
+				__m256d nd = _mm256_add_pd(vik, _mm256_load_pd(Dkj + j));
+				__m256d m = _mm256_cmp_pd(nd, dij, _CMP_LT_OQ);
+				if(_mm256_movemask_pd(m) == 0) continue;
+				_mm256_store_pd(Dij + j, _mm256_blendv_pd(dij, nd, m));
+
+				/* The low half of each 64-bit mask lane picks one next hop */
+				__m128i m32 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_castpd_si256(m), Low));
+				__m128i nij = _mm_load_si128((__m128i *) (Nij + j));
+				_mm_store_si128((__m128i *) (Nij + j), _mm_blendv_epi8(nij, vnik, m32));
+			}
+#elif defined(__SSE2__)
+			__m128d vik = _mm_set1_pd(dik);
+			for(j = jb; j < jb + FLOYD_BLOCK; j += 2)
+			{
+				__m128d dij = _mm_load_pd(Dij + j);
+				__m128d nd = _mm_add_pd(vik, _mm_load_pd(Dkj + j));
+				__m128d m = _mm_cmplt_pd(nd, dij);
+				int Bits = _mm_movemask_pd(m);
+				if(Bits == 0) continue;
+				_mm_store_pd(Dij + j, _mm_or_pd(_mm_and_pd(m, nd), _mm_andnot_pd(m, dij)));
+				if(Bits & 1) Nij[j] = nik;
+				if(Bits & 2) Nij[j+1] = nik;
+			}
+#else
+			for(j = jb; j < jb + FLOYD_BLOCK; j++)
+			{
+				if(dik + Dkj[j] < Dij[j])
+				{
+					Dij[j] = dik + Dkj[j];
+					Nij[j] = nik;
+				}
+			}
+#endif
+		}
+	}
+}
+
+/* Finds the shortest path cost and next hop between every pair of vertices */
+FloydResult* FloydWarshall(graph_t *G)
+{
+	int i, j, e, n, s, ib, jb, kb;
+	size_t Cells;
+	FloydResult *F;
+
+	n = G->NumVert;
+	s = (n + FLOYD_BLOCK - 1) / FLOYD_BLOCK * FLOYD_BLOCK;
+	Cells = (size_t) s * s;
+
+	F = (FloydResult *) malloc(sizeof(FloydResult));
+	F->NumVert = n;
+	F->Stride = s;
+	if(posix_memalign((void **) &F->Dist, 64, Cells * sizeof(double)) != 0 ||
+	   posix_memalign((void **) &F->Next, 64, Cells * sizeof(int)) != 0)
+	{
+		printf("Failed to allocate the %d x %d distance matrix!\n", s, s);
+		exit(1);
+	}
+
+	/* Start from the edges; the padding vertices have no edges at all */
+	for(i = 0; i < s; i++)
+	{
+		for(j = 0; j < s; j++)
+		{
+			F->Dist[(size_t) i * s + j] = (i == j) ? 0 : FLT_MAX;
+			F->Next[(size_t) i * s + j] = (i == j) ? i : -1;
+		}
+	}
+	if(!G->IsSparse)
+	{
+		for(i = 0; i < n; i++)
+		{
+			for(j = 0; j < n; j++)
+			{
+				if(i == j || graph_matrix_weight(G, i, j) == FLT_MAX) continue;
+				F->Dist[(size_t) i * s + j] = graph_matrix_weight(G, i, j);
+				F->Next[(size_t) i * s + j] = j;
+			}
+		}
+	}
+	else
+	{
+		graph_finalize(G);
+		for(i = 0; i < n; i++)
+		{
+			for(e = G->EdgeOffset[i]; e < G->EdgeOffset[i+1]; e++)
+			{
+				if(G->EdgeWeight[e] == FLT_MAX) continue;
+				F->Dist[(size_t) i * s + G->EdgeTarget[e]] = G->EdgeWeight[e];
+				F->Next[(size_t) i * s + G->EdgeTarget[e]] = G->EdgeTarget[e];
+			}
+		}
+	}
+
+	/* Each round finishes the diagonal tile, then its row and column, then the rest */
+	for(kb = 0; kb < s; kb += FLOYD_BLOCK)
+	{
+		FloydTile(F, kb, kb, kb);
+		for(jb = 0; jb < s; jb += FLOYD_BLOCK)
+		{
+			if(jb == kb) continue;
+			FloydTile(F, kb, jb, kb);
+			FloydTile(F, jb, kb, kb);
+		}
+		for(ib = 0; ib < s; ib += FLOYD_BLOCK)
+		{
+			if(ib == kb) continue;
+			for(jb = 0; jb < s; jb += FLOYD_BLOCK)
+				if(jb != kb) FloydTile(F, ib, jb, kb);
+		}
+	}
+
+	return F;
+}
+
+/* Frees the matrices of F */
+void floyd_free(FloydResult *F)
+{
+	free(F->Dist);
+	free(F->Next);
+	free(F);
+}
+
+/* Gives the row of F for LSource as the predecessor and distance arrays made
+ * by ShortestPath, so the paths can be printed with PrintShortestPath
+ */
+void floyd_path(FloydResult *F, int LSource, int **Pred, double **ShDis)
+{
+	int u, v, n = F->NumVert;
+	int *Predecessor = (int *) malloc(n * sizeof(int));
+	double *ShortestDistance = (double *) malloc(n * sizeof(double));
+	double *Row = F->Dist + (size_t) LSource * F->Stride;
+
+	for(v = 0; v < n; v++)
+	{
+		ShortestDistance[v] = Row[v];
+		Predecessor[v] = v;
+	}
+
+	/* The vertex before v is the one whose next hop toward v is v */
+	for(v = 0; v < n; v++)
+	{
+		if(v == LSource || Row[v] == FLT_MAX) continue;
+		for(u = LSource; F->Next[(size_t) u * F->Stride + v] != v; u = F->Next[(size_t) u * F->Stride + v])
+			;
+		Predecessor[v] = u;
+	}
+	Predecessor[LSource] = LSource;
+
+	*Pred = Predecessor;
+	*ShDis = ShortestDistance;
+}
@@ -0,0 +1,22 @@
+/* floyd.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * All-pairs shortest paths by the Floyd-Warshall algorithm, for dense graphs.
+ */
+
+#define FLOYD_BLOCK 64				//Rows and columns in each tile
+
+/* Distance and next-hop matrices, stored row-major with Stride entries per row */
+typedef  struct {
+	int		NumVert;
+	int		Stride;					//NumVert rounded up to a multiple of FLOYD_BLOCK
+	double	*Dist;					//Dist[i*Stride+j] is the cost from i to j
+	int		*Next;					//Next vertex after i on the path to j, -1 if none
+} FloydResult;
+
+FloydResult* FloydWarshall(graph_t *G);
+void floyd_free(FloydResult *F);
+void floyd_path(FloydResult *F, int LSource, int **Pred, double **ShDis);
@@ -19,30 +19,77 @@
 #include <unistd.h>
 #include <limits.h>
 #include <float.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 #include "graph.h"
+#include "heap.h"
+#include "pqueue.h"
+#include "radix.h"
+#include "counters.h"
+#include "trace.h"
+#include "delta.h"
 
 
 /* Creates a graph G with NumVertices amount of vertices */
 graph_t* graph_construct(int NumVertices)
+{
+	return graph_construct_matrix(NumVertices, FALSE);
+}
+
+/* Creates a graph G with NumVertices vertices and an adjacency matrix of
+ * doubles, or of floats if FloatWeights is TRUE
+ */
+graph_t* graph_construct_matrix(int NumVertices, int FloatWeights)
 {
 	int i,j;
+	size_t CellSize, RowCells;
+	void *Block;
 
 	graph_t *G;
     G = (graph_t *) malloc(sizeof(graph_t));
     G->EdgeCount = 0;
+	G->Version = 0;
 //    G->MaxCount = 0;
     G->NumVert = NumVertices;
 
-	/* Allocate space for a 2D Adjacent Matrix */
-    G->AdjMatrix = (double **) malloc(NumVertices * sizeof(double *));
-	for(i=0; i<NumVertices; i++)
-		G->AdjMatrix[i] = (double *) malloc(NumVertices * sizeof(double));
+	/* Allocate one block for the 2D Adjacent Matrix, with rows padded out to
+	 * whole 64-byte cache lines, and point each row into it */
+	G->IsFloat = FloatWeights;
+	CellSize = FloatWeights ? sizeof(float) : sizeof(double);
+	RowCells = (NumVertices * CellSize + 63) / 64 * 64 / CellSize;
+	G->MatrixStride = (int) RowCells;
+	if(posix_memalign(&Block, 64, (NumVertices ? NumVertices : 1) * RowCells * CellSize) != 0)
+	{
+		printf("Failed to allocate the adjacency matrix!\n");
+		exit(1);
+	}
+	COUNT(BytesAllocated, sizeof(graph_t) + NumVertices * (RowCells * CellSize + sizeof(void *) + sizeof(GraphItem *)));
+	G->AdjMatrix = NULL;
+	G->AdjMatrixF = NULL;
+	if(FloatWeights)
+	{
+		G->AdjMatrixF = (float **) malloc(NumVertices * sizeof(float *));
+		for(i=0; i<NumVertices; i++)
+			G->AdjMatrixF[i] = (float *) Block + i * RowCells;
+	}
+	else
+	{
+	    G->AdjMatrix = (double **) malloc(NumVertices * sizeof(double *));
+		for(i=0; i<NumVertices; i++)
+			G->AdjMatrix[i] = (double *) Block + i * RowCells;
+	}
+	if(NumVertices == 0) free(Block);
 
 	/* Set each adjacency to Infinity and same nodes to 0, since no connections exist */
 	for(i=0; i<NumVertices; i++){
 		for(j=0; j<NumVertices; j++){
-			if(i == j) G->AdjMatrix[i][j] = 0;		//Weight is 0 for node to itself 
+			if(FloatWeights) G->AdjMatrixF[i][j] = (i == j) ? 0 : FLT_MAX;
+			else if(i == j) G->AdjMatrix[i][j] = 0;		//Weight is 0 for node to itself 
 			else G->AdjMatrix[i][j] = FLT_MAX;		//Weight is infinite if no edge
 		}
 	}
@@ -54,6 +101,79 @@ graph_t* graph_construct(int NumVertices)
 	for(i=0; i<NumVertices; i++)
 		G->VertArray[i] = NULL;
 
+	/* No CSR arrays until graph_finalize is called */
+	G->IsSparse = FALSE;
+	G->CSRValid = FALSE;
+	G->EdgeOffset = NULL;
+	G->EdgeTarget = NULL;
+	G->EdgeWeight = NULL;
+	G->PendCount = 0;
+	G->PendSize = 0;
+	G->PendSource = NULL;
+	G->PendDest = NULL;
+	G->PendWeight = NULL;
+	G->WeightScale = -1;
+	G->DistanceScale = -1;
+	G->DeltaWidth = -1;
+	G->RevValid = FALSE;
+	G->RevOffset = NULL;
+	G->RevSource = NULL;
+	G->RevWeight = NULL;
+	G->MapBase = NULL;
+	G->MapSize = 0;
+	G->EdgesMapped = FALSE;
+
+    return G;
+}
+
+/* Creates a graph G with NumVertices vertices that stores only its edges,
+ * in compressed sparse row form, instead of a NumVertices^2 matrix 
+ */
+graph_t* graph_construct_sparse(int NumVertices)
+{
+	int i;
+
+	graph_t *G;
+    G = (graph_t *) malloc(sizeof(graph_t));
+    G->EdgeCount = 0;
+	G->Version = 0;
+    G->NumVert = NumVertices;
+	G->AdjMatrix = NULL;
+	G->AdjMatrixF = NULL;
+	G->IsFloat = FALSE;
+	G->MatrixStride = 0;
+
+	/* Allocate space for a Vertex Array */
+	G->VertArray = (GraphItem **) malloc(NumVertices * sizeof(GraphItem *));
+	for(i=0; i<NumVertices; i++)
+		G->VertArray[i] = NULL;
+
+	/* An empty graph has an empty, but valid, CSR form */
+	G->IsSparse = TRUE;
+	G->CSRValid = TRUE;
+	G->EdgeOffset = (int *) calloc(NumVertices + 1, sizeof(int));
+	G->EdgeTarget = NULL;
+	G->EdgeWeight = NULL;
+
+	/* Staging area for graph_add_edge, grown as needed */
+	G->PendCount = 0;
+	G->PendSize = 16;
+	G->PendSource = (int *) malloc(G->PendSize * sizeof(int));
+	G->PendDest = (int *) malloc(G->PendSize * sizeof(int));
+	G->PendWeight = (double *) malloc(G->PendSize * sizeof(double));
+	COUNT(BytesAllocated, sizeof(graph_t) + NumVertices * sizeof(GraphItem *) + (NumVertices + 1) * sizeof(int)
+						  + G->PendSize * (2 * sizeof(int) + sizeof(double)));
+	G->WeightScale = -1;
+	G->DistanceScale = -1;
+	G->DeltaWidth = -1;
+	G->RevValid = FALSE;
+	G->RevOffset = NULL;
+	G->RevSource = NULL;
+	G->RevWeight = NULL;
+	G->MapBase = NULL;
+	G->MapSize = 0;
+	G->EdgesMapped = FALSE;
+
     return G;
 }
 
@@ -62,13 +182,29 @@ void graph_destruct(graph_t *G)
 {
 	int i;
 
-	/* Free matrix before freeing the rest of the structure */
-	for(i=0; i<G->NumVert; i++)
-		free(G->AdjMatrix[i]);
-    free(G->AdjMatrix);
+	/* Free matrix before freeing the rest of the structure.  The first row
+	 * is the start of the block holding every row */
+	if(G->AdjMatrix != NULL)
+	{
+		if(G->NumVert > 0) free(G->AdjMatrix[0]);
+	    free(G->AdjMatrix);
+	}
+	if(G->AdjMatrixF != NULL)
+	{
+		if(G->NumVert > 0) free(G->AdjMatrixF[0]);
+	    free(G->AdjMatrixF);
+	}
 
-	/* Free elements in Vertex Array if it isn't empty */
-	if(G->VertArray != NULL)
+	/* Free the CSR arrays and any edges still waiting to be added to them */
+	if(!G->EdgesMapped)
+	{
+		free(G->EdgeOffset); free(G->EdgeTarget); free(G->EdgeWeight);
+	}
+	free(G->PendSource); free(G->PendDest); free(G->PendWeight);
+	free(G->RevOffset); free(G->RevSource); free(G->RevWeight);
+
+	/* Free elements in Vertex Array if it isn't empty and they weren't loaded */
+	if(G->VertArray != NULL && G->MapBase == NULL)
 	{
 		for(i=0; i<G->NumVert; i++)
 		{
@@ -78,6 +214,7 @@ void graph_destruct(graph_t *G)
 	}
 
     free(G->VertArray);
+	if(G->MapBase != NULL) munmap(G->MapBase, G->MapSize);
     free(G);
 
 }
@@ -86,7 +223,222 @@ void graph_destruct(graph_t *G)
 void graph_add_edge(graph_t *G, int LSource, int LDest, double LWeight)
 {
 	G->EdgeCount = G->EdgeCount + 1;
-	G->AdjMatrix[LSource][LDest] = LWeight;
+	graph_set_weight(G, LSource, LDest, LWeight);
+}
+
+/* Changes the weight of the edge from LSource to LDest without counting it as
+ * a new edge.  A weight of FLT_MAX removes the edge.
+ */
+void graph_set_weight(graph_t *G, int LSource, int LDest, double LWeight)
+{
+	int e;
+
+	G->Version++;										//Searches made before this are out of date
+	if(G->AdjMatrix != NULL) G->AdjMatrix[LSource][LDest] = LWeight;
+	if(G->AdjMatrixF != NULL) G->AdjMatrixF[LSource][LDest] = (float) LWeight;
+	if(G->IsFloat) LWeight = (double) (float) LWeight;	//The CSR form keeps the matrix's rounding
+	if(LWeight != FLT_MAX)								//Must be checked again
+	{
+		G->WeightScale = -1;
+		G->DistanceScale = -1;
+	}
+	G->DeltaWidth = -1;									//Removals change the degree too
+
+	/* Update the CSR entry in place if the edge is already there */
+	if(G->CSRValid)
+	{
+		for(e = G->EdgeOffset[LSource]; e < G->EdgeOffset[LSource+1]; e++)
+		{
+			if(G->EdgeTarget[e] == LDest)
+			{
+				G->EdgeWeight[e] = LWeight;		//FLT_MAX leaves a removed edge behind
+				if(G->RevValid)
+				{
+					for(e = G->RevOffset[LDest]; G->RevSource[e] != LSource; e++)
+						;
+					G->RevWeight[e] = LWeight;
+				}
+				return;
+			}
+		}
+		G->CSRValid = FALSE;
+		G->RevValid = FALSE;
+	}
+	if(!G->IsSparse) return;		//The matrix is rebuilt into CSR form later
+
+	/* Otherwise stage the edge until the next graph_finalize */
+	if(G->PendCount == G->PendSize)
+	{
+		G->PendSize *= 2;
+		G->PendSource = (int *) realloc(G->PendSource, G->PendSize * sizeof(int));
+		G->PendDest = (int *) realloc(G->PendDest, G->PendSize * sizeof(int));
+		G->PendWeight = (double *) realloc(G->PendWeight, G->PendSize * sizeof(double));
+		if(G->PendSource == NULL || G->PendDest == NULL || G->PendWeight == NULL)
+		{
+			printf("Failed to grow the sparse edge list!\n");
+			exit(1);
+		}
+		COUNT(BytesAllocated, G->PendSize / 2 * (2 * sizeof(int) + sizeof(double)));
+	}
+	G->PendSource[G->PendCount] = LSource;
+	G->PendDest[G->PendCount] = LDest;
+	G->PendWeight[G->PendCount] = LWeight;
+	G->PendCount++;
+}
+
+/* Returns the weight of the edge from LSource to LDest, FLT_MAX if there is
+ * no edge, for either storage form
+ */
+double graph_edge_weight(graph_t *G, int LSource, int LDest)
+{
+	int e;
+
+	if(!G->IsSparse) return graph_matrix_weight(G, LSource, LDest);
+	if(LSource == LDest) return 0;
+
+	graph_finalize(G);
+	for(e = G->EdgeOffset[LSource]; e < G->EdgeOffset[LSource+1]; e++)
+		if(G->EdgeTarget[e] == LDest) return G->EdgeWeight[e];
+
+	return FLT_MAX;
+}
+
+/* Builds the CSR arrays of G if they are out of date.
+ *
+ * Dense graphs are converted from the adjacency matrix.  Sparse graphs merge
+ * the previous CSR arrays with the staged edges; the latest weight given to an
+ * edge wins, and edges with a weight of FLT_MAX are dropped.
+ */
+void graph_finalize(graph_t *G)
+{
+	int i, j, e, u, n, Total, Start, InPlace, *Count, *Slot, *TmpTarget;
+	double *TmpWeight;
+
+	if(G->CSRValid) return;
+
+	G->RevValid = FALSE;
+	n = G->NumVert;
+	Count = (int *) calloc(n + 1, sizeof(int));
+
+	if(!G->IsSparse)
+	{
+		/* Count, then copy, the real edges of each matrix row */
+		for(i=0; i<n; i++)
+			for(j=0; j<n; j++)
+				if(i != j && graph_matrix_weight(G, i, j) != FLT_MAX) Count[i+1]++;
+		for(i=0; i<n; i++) Count[i+1] += Count[i];
+
+		free(G->EdgeTarget); free(G->EdgeWeight);
+		G->EdgeTarget = (int *) malloc((Count[n] + 1) * sizeof(int));
+		G->EdgeWeight = (double *) malloc((Count[n] + 1) * sizeof(double));
+		COUNT(BytesAllocated, (n + 1) * sizeof(int) + (Count[n] + 1) * (sizeof(int) + sizeof(double)));
+		for(i=0, e=0; i<n; i++)
+		{
+			for(j=0; j<n; j++)
+			{
+				if(i != j && graph_matrix_weight(G, i, j) != FLT_MAX)
+				{
+					G->EdgeTarget[e] = j;
+					G->EdgeWeight[e] = graph_matrix_weight(G, i, j);
+					e++;
+				}
+			}
+		}
+		free(G->EdgeOffset);
+		G->EdgeOffset = Count;
+		G->CSRValid = TRUE;
+		return;
+	}
+
+	/* With nothing staged and the rows in memory of their own, as graph_read
+	 * leaves them, the rows are compacted where they are */
+	InPlace = (G->PendCount == 0 && !G->EdgesMapped);
+	if(InPlace)
+	{
+		memcpy(Count, G->EdgeOffset, (n + 1) * sizeof(int));
+		TmpTarget = G->EdgeTarget;
+		TmpWeight = G->EdgeWeight;
+		COUNT(BytesAllocated, (n + 1) * sizeof(int) + n * sizeof(int));
+	}
+	else
+	{
+		/* Bucket the old rows followed by the staged edges by source vertex.
+		 * The bucketing is stable, so later weights for an edge come later in
+		 * its row */
+		for(u=0; u<n; u++) Count[u+1] = G->EdgeOffset[u+1] - G->EdgeOffset[u];
+		for(e=0; e<G->PendCount; e++) Count[G->PendSource[e]+1]++;
+		for(u=0; u<n; u++) Count[u+1] += Count[u];
+		Total = Count[n];
+
+		TmpTarget = (int *) malloc((Total + 1) * sizeof(int));
+		TmpWeight = (double *) malloc((Total + 1) * sizeof(double));
+		COUNT(BytesAllocated, (n + 1) * sizeof(int) + (Total + 1) * (sizeof(int) + sizeof(double)) + n * sizeof(int));
+		for(u=0; u<n; u++)
+		{
+			for(e = G->EdgeOffset[u]; e < G->EdgeOffset[u+1]; e++)
+			{
+				TmpTarget[Count[u]] = G->EdgeTarget[e];
+				TmpWeight[Count[u]] = G->EdgeWeight[e];
+				Count[u]++;
+			}
+		}
+		for(e=0; e<G->PendCount; e++)
+		{
+			u = G->PendSource[e];
+			TmpTarget[Count[u]] = G->PendDest[e];
+			TmpWeight[Count[u]] = G->PendWeight[e];
+			Count[u]++;
+		}
+		//Count[u] now holds the end of row u, so shift it back to the start
+		for(u=n; u>0; u--) Count[u] = Count[u-1];
+		Count[0] = 0;
+	}
+
+	/* Compact each row in place, keeping the last weight of repeated edges */
+	Slot = (int *) malloc(n * sizeof(int));
+	for(u=0; u<n; u++) Slot[u] = -1;
+	for(u=0, j=0; u<n; u++)
+	{
+		Start = j;
+		for(e = Count[u]; e < Count[u+1]; e++)
+		{
+			i = TmpTarget[e];
+			if(i == u) continue;						//No self loops
+			if(Slot[i] >= 0) TmpWeight[Slot[i]] = TmpWeight[e];
+			else
+			{
+				Slot[i] = j;
+				TmpTarget[j] = i;
+				TmpWeight[j] = TmpWeight[e];
+				j++;
+			}
+		}
+		/* Reset the slots and squeeze out edges that were removed */
+		for(e = Start, i = Start; e < j; e++)
+		{
+			Slot[TmpTarget[e]] = -1;
+			if(TmpWeight[e] == FLT_MAX) continue;
+			TmpTarget[i] = TmpTarget[e];
+			TmpWeight[i] = TmpWeight[e];
+			i++;
+		}
+		j = i;
+		Count[u] = Start;
+	}
+	Count[n] = j;
+	free(Slot);
+
+	if(InPlace) free(G->EdgeOffset);
+	else if(!G->EdgesMapped)
+	{
+		free(G->EdgeOffset); free(G->EdgeTarget); free(G->EdgeWeight);
+	}
+	G->EdgesMapped = FALSE;
+	G->EdgeOffset = Count;
+	G->EdgeTarget = (int *) realloc(TmpTarget, (j + 1) * sizeof(int));
+	G->EdgeWeight = (double *) realloc(TmpWeight, (j + 1) * sizeof(double));
+	G->PendCount = 0;
+	G->CSRValid = TRUE;
 }
 
 
@@ -95,6 +447,7 @@ GraphItem* graph_generate_node(int LSource, int NumVertices)
 {
 	GraphItem *Item;
 	Item = (GraphItem *) malloc(sizeof(GraphItem));
+	COUNT(BytesAllocated, sizeof(GraphItem));
 	Item->node = LSource;
 
 	/* Location of smallest and largest node are different */
@@ -185,44 +538,429 @@ double FindMaxElement(double ElementArray[], int ElementCount, int *LDest, int *
 	return ElemMax;
 }
 
-/* A function to find the shortest path using Dijkstra's pseudocode */
+/* Builds the reversed CSR arrays of G if they are out of date, so that the
+ * edges into a vertex can be walked as easily as the edges out of it
+ */
+void graph_reverse(graph_t *G)
+{
+	int u, e, n, *Fill;
+
+	graph_finalize(G);
+	if(G->RevValid) return;
+
+	n = G->NumVert;
+	free(G->RevOffset); free(G->RevSource); free(G->RevWeight);
+	G->RevOffset = (int *) calloc(n + 1, sizeof(int));
+	G->RevSource = (int *) malloc((G->EdgeOffset[n] + 1) * sizeof(int));
+	G->RevWeight = (double *) malloc((G->EdgeOffset[n] + 1) * sizeof(double));
+	COUNT(BytesAllocated, (2 * n + 1) * sizeof(int) + (G->EdgeOffset[n] + 1) * (sizeof(int) + sizeof(double)));
+
+	/* Count the in-edges of each vertex, then place the edges by destination */
+	for(e = 0; e < G->EdgeOffset[n]; e++) G->RevOffset[G->EdgeTarget[e]+1]++;
+	for(u = 0; u < n; u++) G->RevOffset[u+1] += G->RevOffset[u];
+
+	Fill = (int *) malloc(n * sizeof(int));
+	memcpy(Fill, G->RevOffset, n * sizeof(int));
+	for(u = 0; u < n; u++)
+	{
+		for(e = G->EdgeOffset[u]; e < G->EdgeOffset[u+1]; e++)
+		{
+			G->RevSource[Fill[G->EdgeTarget[e]]] = u;
+			G->RevWeight[Fill[G->EdgeTarget[e]]] = G->EdgeWeight[e];
+			Fill[G->EdgeTarget[e]]++;
+		}
+	}
+	free(Fill);
+	G->RevValid = TRUE;
+}
+
+/* Finds the smallest multiplier, up to MAX_WEIGHT_SCALE, that turns every edge
+ * weight into a whole number.  Returns 0 if there is none, or if a path of
+ * NumVert scaled edges might not fit in 63 bits.
+ */
+int graph_weight_scale(graph_t *G)
+{
+	int e, Scale;
+	double Scaled, MaxWeight = 0;
+
+	if(G->WeightScale >= 0) return G->WeightScale;
+	graph_finalize(G);
+
+	for(e = 0; e < G->EdgeOffset[G->NumVert]; e++)
+	{
+		if(G->EdgeWeight[e] == FLT_MAX) continue;
+		if(G->EdgeWeight[e] < 0) break;						//Only for costs
+		if(MaxWeight < G->EdgeWeight[e]) MaxWeight = G->EdgeWeight[e];
+	}
+	G->WeightScale = 0;
+	if(e < G->EdgeOffset[G->NumVert]) return 0;
+
+	for(Scale = 1; Scale <= MAX_WEIGHT_SCALE; Scale++)
+	{
+		if(MaxWeight * Scale * G->NumVert > 4e18) break;	//Path cost could overflow
+		for(e = 0; e < G->EdgeOffset[G->NumVert]; e++)
+		{
+			if(G->EdgeWeight[e] == FLT_MAX) continue;
+			Scaled = G->EdgeWeight[e] * Scale;
+			if(fabs(Scaled - rint(Scaled)) > 1e-9 * (Scaled > 1 ? Scaled : 1)) break;
+		}
+		if(e == G->EdgeOffset[G->NumVert])
+		{
+			G->WeightScale = Scale;
+			break;
+		}
+	}
+	return G->WeightScale;
+}
+
+/* Finds the largest Scale with Scale * vertex_distance(u, v) <= weight for
+ * every edge (u, v), so that Scale times the straight-line distance to a
+ * vertex never overestimates the cost of reaching it.  For type-4 graphs this
+ * is the smallest MinDatRate/maximum_data per unit of link length.  Returns 0
+ * if any vertex has no position, which leaves A* as plain Dijkstra.
+ */
+double graph_distance_scale(graph_t *G)
+{
+	int u, e;
+	double Distance, Scale = FLT_MAX;
+
+	if(G->DistanceScale >= 0) return G->DistanceScale;
+	graph_finalize(G);
+
+	G->DistanceScale = 0;
+	for(u = 0; u < G->NumVert; u++)
+		if(G->VertArray == NULL || G->VertArray[u] == NULL) return 0;
+
+	for(u = 0; u < G->NumVert; u++)
+	{
+		for(e = G->EdgeOffset[u]; e < G->EdgeOffset[u+1]; e++)
+		{
+			if(G->EdgeWeight[e] == FLT_MAX) continue;
+			Distance = vertex_distance(G->VertArray[u], G->VertArray[G->EdgeTarget[e]]);
+			if(Distance > 0 && G->EdgeWeight[e] < Scale * Distance)
+				Scale = G->EdgeWeight[e] / Distance;
+		}
+	}
+
+	/* Shaved a little, so rounding can't make the estimate too high */
+	if(Scale < FLT_MAX && Scale > 0) G->DistanceScale = Scale * (1 - 1e-9);
+	return G->DistanceScale;
+}
+
+/* Picks the engine for SP_AUTO: the linear scan for matrices that are mostly
+ * full, then the radix heap when the weights can be made integers, then the
+ * binary heap for sparse graphs
+ */
+int graph_pick_engine(graph_t *G)
+{
+	graph_finalize(G);
+	if(!G->IsSparse && 4.0 * G->EdgeOffset[G->NumVert] > (double) G->NumVert * G->NumVert)
+		return SP_SCAN;
+	if(graph_weight_scale(G) > 0) return SP_RADIX;
+	if(G->IsSparse) return SP_HEAP;
+	return SP_SCAN;
+}
+
+/* Makes an empty workspace.  Its arrays and queues are allocated by the
+ * first search that needs them, with room for the graph being searched.
+ */
+SPWorkspace* workspace_construct(void)
+{
+	return (SPWorkspace *) calloc(1, sizeof(SPWorkspace));
+}
+
+/* Frees the arrays and queues of WS, leaving it empty but for its thread count */
+static void WorkspaceClear(SPWorkspace *WS)
+{
+	int Side, Threads = WS->Threads;
+
+	free(WS->Pred); free(WS->Dist); free(WS->Path); free(WS->Mark); free(WS->Done); free(WS->Key);
+	free(WS->BackPred); free(WS->BackDist); free(WS->BackMark); free(WS->BackWeight);
+	free(WS->Order); free(WS->Sub); free(WS->Child); free(WS->Sibling);
+	for(Side = 0; Side < 2; Side++)
+		if(WS->PQ[Side] != NULL) WS->PQType[Side]->Destruct(WS->PQ[Side]);
+	if(WS->RQ != NULL) RQDestruct((RadixQueue *) WS->RQ);
+	memset(WS, 0, sizeof(SPWorkspace));
+	WS->Threads = Threads;
+}
+
+void workspace_destruct(SPWorkspace *WS)
+{
+	WorkspaceClear(WS);
+	free(WS);
+}
+
+/* Makes room in WS for a search over NumVert vertices.  Anything too small is
+ * dropped, to be allocated again at the new size. */
+static void WorkspaceFit(SPWorkspace *WS, int NumVert)
+{
+	if(WS->Size < NumVert)
+	{
+		WorkspaceClear(WS);
+		WS->Size = NumVert;
+	}
+}
+
+/* Allocates Bytes for one of the arrays of a workspace */
+static void* WorkspaceAlloc(size_t Bytes)
+{
+	void *Array = malloc(Bytes > 0 ? Bytes : 1);
+
+	if(Array == NULL)
+	{
+		printf("Failed to allocate a search workspace!\n");
+		exit(1);
+	}
+	COUNT(BytesAllocated, Bytes);
+	return Array;
+}
+
+/* The array Field of WS, allocated with WS->Size entries on first use */
+#define WS_ARRAY(WS, Field) ((WS)->Field != NULL ? (WS)->Field : \
+	((WS)->Field = WorkspaceAlloc((WS)->Size * sizeof(*(WS)->Field))))
+
+/* Queue Side of WS, an empty queue of the type Ops.  Every search empties its
+ * queues before it returns, so they can be used again as they are. */
+static void* WorkspaceQueue(SPWorkspace *WS, const PQOps *Ops, int Side)
+{
+	if(WS->PQ[Side] != NULL && WS->PQType[Side] != Ops)
+	{
+		WS->PQType[Side]->Destruct(WS->PQ[Side]);
+		WS->PQ[Side] = NULL;
+	}
+	if(WS->PQ[Side] == NULL)
+	{
+		WS->PQ[Side] = Ops->Initialize(WS->Size);
+		WS->PQType[Side] = Ops;
+	}
+	return WS->PQ[Side];
+}
+
+/* Makes room in WS for a search over NumVert vertices kept outside this file,
+ * as search_construct_with does, with the Pred, Dist, Mark and Order arrays
+ * allocated.  Returns the first queue of WS, an empty queue of the type Ops,
+ * which the caller must empty again before WS is used for anything else. */
+void* workspace_prepare(SPWorkspace *WS, int NumVert, const PQOps *Ops)
+{
+	WorkspaceFit(WS, NumVert);
+	WS_ARRAY(WS, Pred); WS_ARRAY(WS, Dist); WS_ARRAY(WS, Mark); WS_ARRAY(WS, Order);
+	return WorkspaceQueue(WS, Ops, 0);
+}
+
+/* Hands the results in WS to the caller, for the searches that return arrays
+ * of their own, and frees the rest of WS */
+static void WorkspaceTake(SPWorkspace *WS, int **Pred, double **ShDis)
+{
+	*Pred = WS->Pred;						//To return the predecessor matrix to the caller
+	*ShDis = WS->Dist;						//To return the shortest distance matrix to the caller
+	WS->Pred = NULL;
+	WS->Dist = NULL;
+	workspace_destruct(WS);
+}
+
+static void SparseSearch(graph_t *G, int LSource, int Verbose, SPWorkspace *WS);
+
+/* Confirmed bit of vertex u in the bitset Done */
+#define DONE_BIT(Done, u) (((Done)[(u) >> 6] >> ((u) & 63)) & 1)
+
+/* One pass of the dense search over row w of the matrix.  Lowers the cost of
+ * each unconfirmed vertex that w reaches more cheaply and, in the same pass,
+ * finds the unconfirmed vertex of least cost, the lowest numbered one on a
+ * tie.  Returns that vertex, or -1 if the rest are out of reach.  With AVX2,
+ * four vertices are handled at a time, with their confirmed bits turned into
+ * a lane mask; two at a time with SSE2 was no faster than the plain loop.
+ */
+static int DenseRelaxMin(graph_t *G, int w, double *Dist, int *Pred, const uint64_t *Done,
+						 int Verbose, int Step)
+{
+	int u = 0, n = G->NumVert, Next = -1;
+	double Dw = Dist[w], Min = FLT_MAX, Weight, Cost;
+	double *Row = G->IsFloat ? NULL : G->AdjMatrix[w];
+	float *RowF = G->IsFloat ? G->AdjMatrixF[w] : NULL;
+
+#if defined(__AVX2__)
+	int j, Bits;
+	double LaneMin[4], LaneNext[4];
+	__m256d vw = _mm256_set1_pd(Dw), vmax = _mm256_set1_pd(FLT_MAX);
+	__m256d vmin = vmax, vnext = _mm256_set1_pd(-1), vidx = _mm256_setr_pd(0, 1, 2, 3);
+	__m256i LaneBit = _mm256_setr_epi64x(1, 2, 4, 8);
+
+	for(; u + 4 <= n; u += 4, vidx = _mm256_add_pd(vidx, _mm256_set1_pd(4)))
+	{
+		__m256i b = _mm256_and_si256(_mm256_set1_epi64x((Done[u >> 6] >> (u & 63)) & 15), LaneBit);
+		__m256d Open = _mm256_castsi256_pd(_mm256_cmpeq_epi64(b, _mm256_setzero_si256()));
+		__m256d r = Row ? _mm256_load_pd(Row + u) : _mm256_cvtps_pd(_mm_load_ps(RowF + u));
+		__m256d d = _mm256_loadu_pd(Dist + u);
+		__m256d nd = _mm256_add_pd(vw, r);
+		__m256d Edge = _mm256_and_pd(Open, _mm256_cmp_pd(r, vmax, _CMP_LT_OQ));
+		__m256d Lower = _mm256_and_pd(Edge, _mm256_cmp_pd(nd, d, _CMP_LT_OQ));
+
+		COUNT(EdgesScanned, __builtin_popcount(_mm256_movemask_pd(Edge)));
+		if((Bits = _mm256_movemask_pd(Lower)) != 0)
+		{
+			d = _mm256_blendv_pd(d, nd, Lower);
+			_mm256_storeu_pd(Dist + u, d);
+			for(j = 0; j < 4; j++)
+			{
+				if(!(Bits & (1 << j))) continue;
+				COUNT(Relaxations, 1);
+				Pred[u+j] = w;
+				if(Verbose) trace_event(TRACE_RELAX, TRACE_ONE_WAY, u+j, w, Step, Dist[u+j]);
+			}
+		}
+
+		/* Each lane keeps its first least cost among the open vertices */
+		d = _mm256_blendv_pd(vmax, d, Open);
+		__m256d Less = _mm256_cmp_pd(d, vmin, _CMP_LT_OQ);
+		vmin = _mm256_blendv_pd(vmin, d, Less);
+		vnext = _mm256_blendv_pd(vnext, vidx, Less);
+	}
+	_mm256_storeu_pd(LaneMin, vmin);
+	_mm256_storeu_pd(LaneNext, vnext);
+	for(j = 0; j < 4; j++)
+	{
+		if(LaneNext[j] >= 0 && (LaneMin[j] < Min || (LaneMin[j] == Min && (int) LaneNext[j] < Next)))
+		{
+			Min = LaneMin[j];
+			Next = (int) LaneNext[j];
+		}
+	}
+#endif
+
+	/* The vertices left over, or all of them without vector instructions */
+	for(; u < n; u++)
+	{
+		if(DONE_BIT(Done, u)) continue;
+		Weight = Row ? Row[u] : (double) RowF[u];
+		if(Weight < FLT_MAX)
+		{
+			COUNT(EdgesScanned, 1);
+			Cost = Dw + Weight;
+			if(Cost < Dist[u])
+			{
+				COUNT(Relaxations, 1);
+				Dist[u] = Cost;
+				Pred[u] = w;
+				if(Verbose) trace_event(TRACE_RELAX, TRACE_ONE_WAY, u, w, Step, Cost);
+			}
+		}
+		if(Dist[u] < Min)
+		{
+			Min = Dist[u];
+			Next = u;
+		}
+	}
+	return Next;
+}
+
+/* A function to find the shortest path using Dijkstra's pseudocode.  The
+ * confirmed set W is a bitset, and each pass over a row of the matrix both
+ * relaxes the vertices in V - W and picks the next vertex to confirm, so the
+ * search ends once every vertex is confirmed or none left can be reached.
+ */
+static void DenseSearch(graph_t *G, int LSource, int Verbose, SPWorkspace *WS)
+{
+	int u, w, Confirmed;
+	int *Predecessor;
+	double *ShortestDistance;
+	uint64_t *Done;
+
+	/* Without a matrix, only the out-edges can be walked */
+	if(G->IsSparse)
+	{
+		SparseSearch(G, LSource, Verbose, WS);
+		return;
+	}
+
+	/* The arrays come from the workspace, and the bitset starts out clear */
+	WorkspaceFit(WS, G->NumVert);
+	Predecessor = WS_ARRAY(WS, Pred);
+	ShortestDistance = WS_ARRAY(WS, Dist);
+	if(WS->Done == NULL) WS->Done = WorkspaceAlloc((WS->Size / 64 + 1) * sizeof(uint64_t));
+	Done = WS->Done;
+	memset(Done, 0, (G->NumVert / 64 + 1) * sizeof(uint64_t));
+
+	if (Verbose) trace_event(TRACE_START, TRACE_ONE_WAY, LSource, -1, 0, 0);
+
+	/* Only the source is confirmed at first; the pass over its row sets the
+	 * starting costs, as the first row of the matrix */
+	for(u=0; u < G->NumVert; u++) {
+		Predecessor[u] = LSource;
+		ShortestDistance[u] = FLT_MAX;
+	}
+	ShortestDistance[LSource] = 0;
+	Done[LSource >> 6] |= (uint64_t) 1 << (LSource & 63);
+	Confirmed = 1;
+	w = DenseRelaxMin(G, LSource, ShortestDistance, Predecessor, Done, FALSE, Confirmed);
+
+	/* Repeatedly enlarge W with the vertex w in V - W at the minimum distance */
+	while(w >= 0)
+	{
+		Done[w >> 6] |= (uint64_t) 1 << (w & 63);
+		Confirmed++;
+		COUNT(Settled, 1);
+		if (Verbose) trace_event(TRACE_SETTLE, TRACE_ONE_WAY, w, Predecessor[w], Confirmed, ShortestDistance[w]);
+		if(Confirmed == G->NumVert) break;
+
+		// update the shortest distances to vertices in V - W via w, and find the next w
+		w = DenseRelaxMin(G, w, ShortestDistance, Predecessor, Done, Verbose, Confirmed);
+	}
+
+	//If the points can't be reached, those remaining are infinite
+	if(Confirmed < G->NumVert)
+	{
+		for(u=0; u < G->NumVert; u++)
+			if(!DONE_BIT(Done, u)) Predecessor[u] = u;
+	}
+    if (Verbose) trace_event(TRACE_DONE, TRACE_ONE_WAY, -1, -1, Confirmed, 0);
+}
+
+/* The search above, returning arrays that the caller frees */
 void ShortestPath(graph_t *G, int LSource, int Verbose, int **Pred, double **ShDis)
 {
-	int u, v, w, VComp=0;
+	SPWorkspace *WS = workspace_construct();
+
+	DenseSearch(G, LSource, Verbose, WS);
+	WorkspaceTake(WS, Pred, ShDis);
+}
+
+/* The same search as ShortestPath, but the distances are only updated along
+ * the out-edges of each confirmed vertex in the CSR arrays instead of across a
+ * whole row of the adjacency matrix
+ */
+static void SparseSearch(graph_t *G, int LSource, int Verbose, SPWorkspace *WS)
+{
+	int u, v, w, e, Confirmed;
 	double MinDistance, cost_to_u_via_w;
-	int *V, *W, *Predecessor;
+	int *W, *Predecessor;
 	double *ShortestDistance;
 
-	/* Since arrays can't be of variable size, allocate space for arrays */
-	V = (int *) malloc(G->NumVert * sizeof(int));
-	W = (int *) malloc(G->NumVert * sizeof(int));
-	Predecessor = (int *) malloc(G->NumVert * sizeof(int));
-	ShortestDistance = (double *) malloc(G->NumVert * sizeof(double));
+	graph_finalize(G);
+
+	WorkspaceFit(WS, G->NumVert);
+	W = WS_ARRAY(WS, Mark);
+	Predecessor = WS_ARRAY(WS, Pred);
+	ShortestDistance = WS_ARRAY(WS, Dist);
 
 	int count_added = 1;	//For verbose prints
-	if (Verbose) printf("Starting at node %d\n", LSource);
+	if (Verbose) trace_event(TRACE_START, TRACE_ONE_WAY, LSource, -1, 0, 0);
 
-	// Initialize W and ShortestDistance[u] as follows:
-	/* Initialize arrays and set empty spaces to 0's to avoid errors */
+	/* Nothing is confirmed and nothing is reachable yet */
 	for(u=0; u < G->NumVert; u++) {
-		V[u] = u;						//Set Vertex array for later code
 		W[u] = -1;
 		Predecessor[u] = LSource;
-		ShortestDistance[u] = G->AdjMatrix[LSource][u];
+		ShortestDistance[u] = FLT_MAX;
 	}
 
-	// Setting starting location
+	// Setting starting location, with its neighbors at the cost of their edge
 	W[LSource] = LSource;
 	ShortestDistance[LSource] = 0;
-	Predecessor[LSource] = LSource;
+	for(e = G->EdgeOffset[LSource]; e < G->EdgeOffset[LSource+1]; e++)
+		ShortestDistance[G->EdgeTarget[e]] = G->EdgeWeight[e];
+	Confirmed = 1;
 
-	//Loop to see if V and C are the same
-	for(u=0; u < G->NumVert; u++) {
-		if(V[u] != W[u]) VComp = 1;		//Must compare vertices of the matrix one at a time
-	}
-
-	/* Repeatedly enlarge W until W includes all vertices in V */
-	while(VComp == 1)
+	/* Repeatedly enlarge W until W includes all vertices */
+	while(Confirmed < G->NumVert)
 	{
         // find the vertex w in V - W at the minimum distance from source
 		MinDistance = FLT_MAX;
@@ -230,82 +968,731 @@ void ShortestPath(graph_t *G, int LSource, int Verbose, int **Pred, double **ShD
 
         for (v=0; v < G->NumVert; v++) 
 		{
-			if (W[v] == -1)				//Only for each v in V - W, so while W doesn't have vertex
+			if (W[v] == -1 && ShortestDistance[v] < MinDistance) 
 			{
-				//Distance can't be 0
-		        if (ShortestDistance[v] < MinDistance) 
-				{
-		            MinDistance = ShortestDistance[v];
-		            w = v;
-		        }
+				MinDistance = ShortestDistance[v];
+				w = v;
 			}
         }
 
-        // if a vertex w was found, add w to W, the confirmed set
-		if(w < G->NumVert)				//point is within the range
+		//If the points can't be reached, those remaining are infinite
+		if(w == G->NumVert)
+		{
+			for(u=0; u < G->NumVert; u++) {
+				if(W[u] == -1) Predecessor[u] = u;
+			}
+			break;
+		}
+
+		// add w to W, the confirmed set
+		W[w] = w;
+		Confirmed++;
+		COUNT(Settled, 1);
+		COUNT(EdgesScanned, G->EdgeOffset[w+1] - G->EdgeOffset[w]);
+		if (Verbose) {
+			count_added++;
+			trace_event(TRACE_SETTLE, TRACE_ONE_WAY, w, Predecessor[w], count_added, MinDistance);
+		}
+
+		// update the shortest distances to the unconfirmed neighbors of w
+		for(e = G->EdgeOffset[w]; e < G->EdgeOffset[w+1]; e++)
 		{
-		    W[w] = w;
-		    if (Verbose) {
-				count_added++;
-		        printf("%d: %d confirmed with cost %g and predecessor %d\n", 
-		                count_added, w, MinDistance, Predecessor[w]);
-		    }
-		    // update the shortest distances to vertices in V - W via w 
-		    for (u=0; u < G->NumVert; u++) 
+			u = G->EdgeTarget[e];
+			if (W[u] != -1 || G->EdgeWeight[e] == FLT_MAX) continue;
+
+			cost_to_u_via_w = ShortestDistance[w] + G->EdgeWeight[e];
+			if (cost_to_u_via_w < ShortestDistance[u]) 
 			{
-				if (W[u] == -1)			//Only for each u in V - W, so while W doesn't have vertex
+				COUNT(Relaxations, 1);
+				ShortestDistance[u] = cost_to_u_via_w;
+				Predecessor[u]=w;
+				if (Verbose) 
 				{
-		        	// if vertex u is a neighbor of w
-					if (G->AdjMatrix[w][u] < FLT_MAX)
-					{
-		            	cost_to_u_via_w = ShortestDistance[w] + G->AdjMatrix[w][u];
-		            	if (cost_to_u_via_w < ShortestDistance[u]) 
-						{
-		                	ShortestDistance[u] = cost_to_u_via_w;
-							Predecessor[u]=w;
-		                	if (Verbose) 
-							{
-		                    	printf("\tdest %d has lower cost %g with predecessor %d\n", u, cost_to_u_via_w, w);
-		                	}
-		            	}
-		        	}
+					trace_event(TRACE_RELAX, TRACE_ONE_WAY, u, w, count_added, cost_to_u_via_w);
 				}
-		    }
+			}
+		}
+    }
+    if (Verbose) trace_event(TRACE_DONE, TRACE_ONE_WAY, -1, -1, count_added, 0);
+}
+
+/* The search above, returning arrays that the caller frees */
+void ShortestPathSparse(graph_t *G, int LSource, int Verbose, int **Pred, double **ShDis)
+{
+	SPWorkspace *WS = workspace_construct();
+
+	SparseSearch(G, LSource, Verbose, WS);
+	WorkspaceTake(WS, Pred, ShDis);
+}
+
+static void QueueSearch(int NumVert, int *Offset, int *Target, double *Weight, const PQOps *Ops,
+						int LSource, int Verbose, SPWorkspace *WS, PQStats *Stats);
+
+/* Dijkstra's algorithm with the unconfirmed vertices kept in the binary heap
+ * from heap2.c.  Lowering the cost of a vertex reinserts it, which moves it up
+ * in the heap instead of adding a duplicate, so each search takes
+ * O((V+E) log V) instead of O(V^2).
+ */
+void ShortestPathHeap(graph_t *G, int LSource, int Verbose, int **Pred, double **ShDis)
+{
+	ShortestPathQueue(G, &PQBinary, LSource, Verbose, Pred, ShDis, NULL);
+}
+
+/* Dijkstra's algorithm with any of the priority queues in pqueue.h.  If Stats
+ * isn't NULL it is filled in with the queue operations the search made.
+ */
+void ShortestPathQueue(graph_t *G, const PQOps *Ops, int LSource, int Verbose, int **Pred, double **ShDis, PQStats *Stats)
+{
+	SPWorkspace *WS = workspace_construct();
+
+	ShortestPathQueueWith(G, Ops, LSource, Verbose, WS, Stats);
+	WorkspaceTake(WS, Pred, ShDis);
+}
+
+void ShortestPathQueueWith(graph_t *G, const PQOps *Ops, int LSource, int Verbose, SPWorkspace *WS, PQStats *Stats)
+{
+	graph_finalize(G);
+	QueueSearch(G->NumVert, G->EdgeOffset, G->EdgeTarget, G->EdgeWeight, Ops, LSource, Verbose, WS, Stats);
+}
+
+/* Finds the shortest distance from every vertex to LDest by searching the
+ * reversed edges.  Succ[u] is the next vertex after u on its path to LDest.
+ */
+void ShortestPathReverse(graph_t *G, int LDest, int Verbose, int **Succ, double **ShDis)
+{
+	SPWorkspace *WS = workspace_construct();
+
+	ShortestPathReverseWith(G, LDest, Verbose, WS);
+	WorkspaceTake(WS, Succ, ShDis);
+}
+
+/* ShortestPathReverse into WS, with the successors in WS->Pred */
+void ShortestPathReverseWith(graph_t *G, int LDest, int Verbose, SPWorkspace *WS)
+{
+	graph_reverse(G);
+	QueueSearch(G->NumVert, G->RevOffset, G->RevSource, G->RevWeight, &PQDHeap4, LDest, Verbose, WS, NULL);
+}
+
+/* Finds the shortest path from LSource to LDest with Dijkstra's algorithm run
+ * forward from LSource and backward from LDest at the same time.  Mu is the
+ * shortest path found so far through a vertex labeled by both searches, and
+ * no shorter path can remain once the costs of the last vertices confirmed
+ * on each side add up to Mu.  Only the vertices on the path are given a final
+ * cost in ShDis; Pred holds the path in the form PrintShortestPath expects.
+ */
+void ShortestPathPair(graph_t *G, int LSource, int LDest, int Verbose, int **Pred, double **ShDis)
+{
+	SPWorkspace *WS = workspace_construct();
+
+	ShortestPathPairWith(G, LSource, LDest, Verbose, WS);
+	WorkspaceTake(WS, Pred, ShDis);
+}
+
+/* ShortestPathPair into WS, with the path in WS->Pred and WS->Dist */
+void ShortestPathPairWith(graph_t *G, int LSource, int LDest, int Verbose, SPWorkspace *WS)
+{
+	int u, w, e, n, Side, Meet, count_added = 0;
+	int *Offset[2], *Target[2], *Done[2], *Link[2];
+	double *Weight[2], *Cost[2], Last[2], Mu, cost_to_u_via_w;
+	double *LinkWeight;
+	void *PQ[2];
+	PQItem Item;
+
+	graph_finalize(G);
+	graph_reverse(G);
+	n = G->NumVert;
+
+	/* Side 0 searches the edges forward from the source, side 1 searches
+	 * them backward from the destination */
+	Offset[0] = G->EdgeOffset; Target[0] = G->EdgeTarget; Weight[0] = G->EdgeWeight;
+	Offset[1] = G->RevOffset; Target[1] = G->RevSource; Weight[1] = G->RevWeight;
+
+	/* The forward side uses the arrays for the results */
+	WorkspaceFit(WS, n);
+	Done[0] = WS_ARRAY(WS, Mark); Link[0] = WS_ARRAY(WS, Pred); Cost[0] = WS_ARRAY(WS, Dist);
+	Done[1] = WS_ARRAY(WS, BackMark); Link[1] = WS_ARRAY(WS, BackPred); Cost[1] = WS_ARRAY(WS, BackDist);
+	LinkWeight = WS_ARRAY(WS, BackWeight);		//Weight of the edge to Link[1][u]
+	for(Side = 0; Side < 2; Side++)
+	{
+		for(u = 0; u < n; u++) {
+			Done[Side][u] = FALSE;
+			Link[Side][u] = u;			//Stays u if the vertex is never reached
+			Cost[Side][u] = FLT_MAX;
 		}
-		else		//If the points can't be reached, those remaining are infinite
+		PQ[Side] = WorkspaceQueue(WS, &PQDHeap4, Side);
+		Last[Side] = 0;
+	}
+
+	if (Verbose) trace_event(TRACE_START, TRACE_BOTH, LSource, LDest, 0, 0);
+	Cost[0][LSource] = 0;
+	Cost[1][LDest] = 0;
+	Item.weight = 0;
+	Item.node = LSource;
+	PQDHeap4.Insert(Item, PQ[0]);
+	Item.node = LDest;
+	PQDHeap4.Insert(Item, PQ[1]);
+	Mu = (LSource == LDest) ? 0 : FLT_MAX;
+	Meet = LSource;
+
+	while(!PQDHeap4.Empty(PQ[0]) && !PQDHeap4.Empty(PQ[1]) && Last[0] + Last[1] < Mu)
+	{
+		// grow the side that has reached the shorter distance so far
+		Side = (Last[0] <= Last[1]) ? 0 : 1;
+		Item = PQDHeap4.Remove(PQ[Side]);
+		w = Item.node;
+		Last[Side] = Item.weight;
+		Done[Side][w] = TRUE;
+		count_added++;
+		COUNT(Settled, 1);
+		COUNT(EdgesScanned, Offset[Side][w+1] - Offset[Side][w]);
+		if (Verbose) {
+			trace_event(TRACE_SETTLE, Side ? TRACE_BACKWARD : TRACE_FORWARD, w, Link[Side][w], count_added, Cost[Side][w]);
+		}
+
+		// update the unconfirmed neighbors of w, and the best meeting point
+		for(e = Offset[Side][w]; e < Offset[Side][w+1]; e++)
 		{
-			//Loop to find missing values in W
-			for(u=0; u < G->NumVert; u++) {
-				if(W[u] == -1)
+			u = Target[Side][e];
+			if (Done[Side][u] || Weight[Side][e] == FLT_MAX) continue;
+
+			cost_to_u_via_w = Cost[Side][w] + Weight[Side][e];
+			if (cost_to_u_via_w < Cost[Side][u])
+			{
+				COUNT(Relaxations, 1);
+				Cost[Side][u] = cost_to_u_via_w;
+				Link[Side][u] = w;
+				if (Side) LinkWeight[u] = Weight[Side][e];
+				Item.node = u;
+				Item.weight = cost_to_u_via_w;
+				PQDHeap4.Insert(Item, PQ[Side]);
+				if (Cost[!Side][u] != FLT_MAX && cost_to_u_via_w + Cost[!Side][u] < Mu)
 				{
-					W[u]=u;
-					Predecessor[u] = u;
+					Mu = cost_to_u_via_w + Cost[!Side][u];
+					Meet = u;
 				}
 			}
 		}
-		VComp = 0;
+	}
+	if (Verbose)
+	{
+		if (Mu != FLT_MAX) trace_event(TRACE_FOUND, TRACE_BOTH, LDest, Meet, count_added, Mu);
+		trace_event(TRACE_DONE, TRACE_BOTH, -1, -1, count_added, 0);
+	}
 
-		//Loop to see if V and C are the same
-		for(u=0; u < G->NumVert; u++) {
-			if(V[u] != W[u]) VComp = 1;		//Must compare vertices of the matrix one at a time
+	/* The forward costs and predecessors already describe the path up to the
+	 * meeting point; extend them along the backward half to LDest */
+	if (Mu != FLT_MAX)
+	{
+		for(w = Meet; w != LDest; w = u)
+		{
+			u = Link[1][w];
+			Link[0][u] = w;
+			Cost[0][u] = Cost[0][w] + LinkWeight[w];
 		}
-    }
-    if (Verbose) printf("Found %d nodes, including source\n", count_added);
+	}
+
+	/* The search may stop with vertices still queued */
+	for(Side = 0; Side < 2; Side++)
+		while(!PQDHeap4.Empty(PQ[Side])) PQDHeap4.Remove(PQ[Side]);
+}
 
-	*Pred = Predecessor;					//To return the predecessor matrix to the caller
-	*ShDis = ShortestDistance;				//To return the shortest distance matrix to the caller
+/* A* search from LSource to LDest.  Vertices leave the queue in order of
+ * their cost plus graph_distance_scale times their straight-line distance to
+ * LDest.  That estimate never exceeds the true remaining cost, and falls by
+ * no more than the weight of any edge, so each vertex is still confirmed only
+ * once, with its shortest cost, and the search ends when LDest is confirmed.
+ */
+void ShortestPathAStar(graph_t *G, int LSource, int LDest, int Verbose, int **Pred, double **ShDis)
+{
+	SPWorkspace *WS = workspace_construct();
 
-	free(V); free(W); 
+	ShortestPathAStarWith(G, LSource, LDest, Verbose, WS);
+	WorkspaceTake(WS, Pred, ShDis);
 }
 
-/* Prints the shortest path and returns an array holding the backwards path */
-int* PrintShortestPath(graph_t *G, int LSource, int LDest, int Pred[], double ShortDist[])
+/* ShortestPathAStar into WS, with the results in WS->Pred and WS->Dist */
+void ShortestPathAStarWith(graph_t *G, int LSource, int LDest, int Verbose, SPWorkspace *WS)
 {
-	int i=0, j=0, *ShortPath;
+	int u, w, e, count_added = 0;
+	int *W, *Predecessor;
+	double *ShortestDistance, Scale, cost_to_u_via_w;
+	void *PQ;
+	PQItem Item;
+
+	Scale = graph_distance_scale(G);	//Also makes sure the CSR form is built
+
+	WorkspaceFit(WS, G->NumVert);
+	W = WS_ARRAY(WS, Mark);
+	Predecessor = WS_ARRAY(WS, Pred);
+	ShortestDistance = WS_ARRAY(WS, Dist);
+	PQ = WorkspaceQueue(WS, &PQDHeap4, 0);
+
+	if (Verbose) trace_event(TRACE_START, TRACE_ONE_WAY, LSource, LDest, 0, Scale);
+	for(u=0; u < G->NumVert; u++) {
+		W[u] = FALSE;
+		Predecessor[u] = u;				//Stays u if the vertex is never reached
+		ShortestDistance[u] = FLT_MAX;
+	}
+
+	ShortestDistance[LSource] = 0;
+	Item.node = LSource;
+	Item.weight = 0;
+	PQDHeap4.Insert(Item, PQ);
+
+	while(!PQDHeap4.Empty(PQ))
+	{
+		// the vertex w at the front of the queue has the lowest estimated total
+		w = PQDHeap4.Remove(PQ).node;
+		W[w] = TRUE;
+		count_added++;
+		COUNT(Settled, 1);
+		if (Verbose && w != LSource) {
+			trace_event(TRACE_SETTLE, TRACE_ONE_WAY, w, Predecessor[w], count_added, ShortestDistance[w]);
+		}
+		if (w == LDest)
+		{
+			if (Verbose) trace_event(TRACE_FOUND, TRACE_ONE_WAY, w, Predecessor[w], count_added, ShortestDistance[w]);
+			break;
+		}
+		COUNT(EdgesScanned, G->EdgeOffset[w+1] - G->EdgeOffset[w]);
+
+		// update the unconfirmed neighbors of w, queued by cost plus estimate
+		for(e = G->EdgeOffset[w]; e < G->EdgeOffset[w+1]; e++)
+		{
+			u = G->EdgeTarget[e];
+			if (W[u] || G->EdgeWeight[e] == FLT_MAX) continue;
+
+			cost_to_u_via_w = ShortestDistance[w] + G->EdgeWeight[e];
+			if (cost_to_u_via_w < ShortestDistance[u])
+			{
+				COUNT(Relaxations, 1);
+				ShortestDistance[u] = cost_to_u_via_w;
+				Predecessor[u] = w;
+				Item.node = u;
+				Item.weight = cost_to_u_via_w;
+				if (Scale > 0) Item.weight += Scale * vertex_distance(G->VertArray[u], G->VertArray[LDest]);
+				PQDHeap4.Insert(Item, PQ);
+			}
+		}
+	}
+	if (Verbose) trace_event(TRACE_DONE, TRACE_ONE_WAY, -1, -1, count_added, 0);
+
+	/* The search stops at LDest with vertices still queued */
+	while(!PQDHeap4.Empty(PQ)) PQDHeap4.Remove(PQ);
+}
+
+/* Sets the weights of Count edges, edge i going from LFrom[i] to LTo[i] and
+ * getting LWeight[i] (FLT_MAX to remove it), then repairs the Pred and ShDis
+ * arrays of an earlier search from LSource to match, without searching the
+ * whole graph again.
+ *
+ * A higher weight only matters for an edge on the tree of shortest paths.
+ * The vertices below such an edge lose their costs, and each one starts over
+ * from its best in-edge from outside those subtrees.  A lower weight can only
+ * shorten paths through its edge, so its far end starts over from the edge.
+ * Dijkstra's algorithm from the vertices that started over then goes only as
+ * far as costs keep improving.  Adding an edge to a sparse graph rebuilds its
+ * CSR form; changing an edge that is already there doesn't.
+ */
+void ShortestPathUpdate(graph_t *G, int LSource, int Count, const int *LFrom, const int *LTo, const double *LWeight,
+						int *Pred, double *ShDis)
+{
+	SPWorkspace *WS = workspace_construct();
+
+	/* Lend the arrays to a workspace for the repair, and take them back */
+	WS->Size = G->NumVert;
+	WS->Pred = Pred;
+	WS->Dist = ShDis;
+	ShortestPathUpdateWith(G, LSource, Count, LFrom, LTo, LWeight, WS);
+	WS->Pred = NULL;
+	WS->Dist = NULL;
+	workspace_destruct(WS);
+}
+
+/* ShortestPathUpdate of the search from LSource held in WS->Pred and WS->Dist,
+ * which must be the last search made with WS.  Changes of more edges than the
+ * graph has vertices need arrays of their own for the old and new weights;
+ * the rest of the update allocates nothing after the first. */
+void ShortestPathUpdateWith(graph_t *G, int LSource, int Count, const int *LFrom, const int *LTo, const double *LWeight,
+							SPWorkspace *WS)
+{
+	int u, v, w, e, i, Cut = FALSE, Affected, *Pred, *Mark, *Sub, *Child, *Sibling;
+	double *ShDis, *OldWeight, *NewWeight, cost_to_u_via_w;
+	void *PQ;
+	PQItem Item;
+
+	Pred = WS->Pred;
+	ShDis = WS->Dist;
+
+	/* Make the changes, then compare each edge's weight before and after all
+	 * of them, in case an edge is changed more than once.  The weights borrow
+	 * the backward arrays when they fit. */
+	if(Count <= WS->Size)
+	{
+		OldWeight = WS_ARRAY(WS, BackDist);
+		NewWeight = WS_ARRAY(WS, BackWeight);
+	}
+	else
+	{
+		OldWeight = (double *) malloc(Count * sizeof(double));
+		NewWeight = (double *) malloc(Count * sizeof(double));
+	}
+	for(i = 0; i < Count; i++)
+		OldWeight[i] = graph_edge_weight(G, LFrom[i], LTo[i]);
+	for(i = 0; i < Count; i++)
+		graph_set_weight(G, LFrom[i], LTo[i], LWeight[i]);
+	for(i = 0; i < Count; i++)
+	{
+		NewWeight[i] = graph_edge_weight(G, LFrom[i], LTo[i]);
+		if(NewWeight[i] > OldWeight[i] && Pred[LTo[i]] == LFrom[i] && LFrom[i] != LTo[i] && ShDis[LTo[i]] != FLT_MAX)
+			Cut = TRUE;
+	}
+	graph_reverse(G);						//Also builds the CSR form
+
+	Mark = WS_ARRAY(WS, Mark);				//TRUE for the vertices cut off the tree
+	for(v = 0; v < G->NumVert; v++) Mark[v] = FALSE;
+	Sub = WS_ARRAY(WS, Sub);
+	PQ = WorkspaceQueue(WS, &PQDHeap4, 0);
+	Affected = 0;
+
+	if(Cut)
+	{
+		/* Link each vertex of the tree to its first child and next sibling */
+		Child = WS_ARRAY(WS, Child);
+		Sibling = WS_ARRAY(WS, Sibling);
+		for(v = 0; v < G->NumVert; v++) Child[v] = -1;
+		for(v = 0; v < G->NumVert; v++)
+		{
+			if(v == LSource || Pred[v] == v || ShDis[v] == FLT_MAX) continue;
+			Sibling[v] = Child[Pred[v]];
+			Child[Pred[v]] = v;
+		}
+
+		/* Collect the subtrees below the edges that got more expensive */
+		for(i = 0; i < Count; i++)
+		{
+			v = LTo[i];
+			if(NewWeight[i] <= OldWeight[i] || Pred[v] != LFrom[i] || Mark[v] || v == LSource || ShDis[v] == FLT_MAX)
+				continue;
+			Mark[v] = TRUE;
+			Sub[Affected++] = v;
+		}
+		for(i = 0; i < Affected; i++)
+			for(v = Child[Sub[i]]; v >= 0; v = Sibling[v])
+				if(!Mark[v]) {
+					Mark[v] = TRUE;
+					Sub[Affected++] = v;
+				}
+		for(i = 0; i < Affected; i++) {
+			ShDis[Sub[i]] = FLT_MAX;
+			Pred[Sub[i]] = Sub[i];
+		}
+
+		/* Each vertex cut off starts from its best way in from outside */
+		for(i = 0; i < Affected; i++)
+		{
+			w = Sub[i];
+			for(e = G->RevOffset[w]; e < G->RevOffset[w+1]; e++)
+			{
+				u = G->RevSource[e];
+				if(Mark[u] || ShDis[u] == FLT_MAX || G->RevWeight[e] == FLT_MAX) continue;
+				if(ShDis[u] + G->RevWeight[e] < ShDis[w])
+				{
+					ShDis[w] = ShDis[u] + G->RevWeight[e];
+					Pred[w] = u;
+				}
+			}
+			if(ShDis[w] != FLT_MAX)
+			{
+				Item.node = w;
+				Item.weight = ShDis[w];
+				PQDHeap4.Insert(Item, PQ);
+			}
+		}
+	}
+
+	/* The far end of an edge that got cheaper may now be reached through it */
+	for(i = 0; i < Count; i++)
+	{
+		u = LFrom[i];
+		v = LTo[i];
+		if(NewWeight[i] >= OldWeight[i] || Mark[u] || ShDis[u] == FLT_MAX || u == v) continue;
+		if(ShDis[u] + NewWeight[i] < ShDis[v])
+		{
+			ShDis[v] = ShDis[u] + NewWeight[i];
+			Pred[v] = u;
+			Item.node = v;
+			Item.weight = ShDis[v];
+			PQDHeap4.Insert(Item, PQ);
+		}
+	}
+
+	/* Dijkstra's algorithm from the queued vertices, over the costs that improve */
+	while(!PQDHeap4.Empty(PQ))
+	{
+		w = PQDHeap4.Remove(PQ).node;
+		COUNT(Settled, 1);
+		COUNT(EdgesScanned, G->EdgeOffset[w+1] - G->EdgeOffset[w]);
+		for(e = G->EdgeOffset[w]; e < G->EdgeOffset[w+1]; e++)
+		{
+			u = G->EdgeTarget[e];
+			if(G->EdgeWeight[e] == FLT_MAX) continue;
+
+			cost_to_u_via_w = ShDis[w] + G->EdgeWeight[e];
+			if(cost_to_u_via_w < ShDis[u])
+			{
+				COUNT(Relaxations, 1);
+				ShDis[u] = cost_to_u_via_w;
+				Pred[u] = w;
+				Item.node = u;
+				Item.weight = cost_to_u_via_w;
+				PQDHeap4.Insert(Item, PQ);
+			}
+		}
+	}
+
+	if(Count > WS->Size) { free(OldWeight); free(NewWeight); }
+}
+
+/* The search behind ShortestPathQueue, over NumVert vertices whose edges are
+ * given in CSR form, so the same code can walk the edges in either direction
+ */
+static void QueueSearch(int NumVert, int *Offset, int *Target, double *Weight, const PQOps *Ops,
+						int LSource, int Verbose, SPWorkspace *WS, PQStats *Stats)
+{
+	int u, w, e, Queued = 0;
+	double cost_to_u_via_w;
+	int *W, *Predecessor;
+	double *ShortestDistance;
+	void *PQ;
+	PQItem Item;
+	PQStats Count = {0, 0, 0, 0};
+
+	WorkspaceFit(WS, NumVert);
+	W = WS_ARRAY(WS, Mark);
+	Predecessor = WS_ARRAY(WS, Pred);
+	ShortestDistance = WS_ARRAY(WS, Dist);
+	PQ = WorkspaceQueue(WS, Ops, 0);
+
+	int count_added = 0;	//For verbose prints
+	if (Verbose) trace_event(TRACE_START, TRACE_ONE_WAY, LSource, -1, 0, 0);
+
+	for(u=0; u < NumVert; u++) {
+		W[u] = -1;
+		Predecessor[u] = u;				//Stays u if the vertex is never reached
+		ShortestDistance[u] = FLT_MAX;
+	}
+
+	/* The search starts with only the source in the queue */
+	ShortestDistance[LSource] = 0;
+	Predecessor[LSource] = LSource;
+	Item.node = LSource;
+	Item.weight = 0;
+	Ops->Insert(Item, PQ);
+	Count.Inserts++;
+	Queued = 1;
+
+	while(!Ops->Empty(PQ))
+	{
+		// the vertex w at the front of the queue is the closest unconfirmed one
+		Item = Ops->Remove(PQ);
+		Count.Removes++;
+		Queued--;
+		w = Item.node;
+		W[w] = w;
+		count_added++;
+		COUNT(Settled, 1);
+		COUNT(EdgesScanned, Offset[w+1] - Offset[w]);
+		if (Verbose && w != LSource) {
+			trace_event(TRACE_SETTLE, TRACE_ONE_WAY, w, Predecessor[w], count_added, ShortestDistance[w]);
+		}
+
+		// update the shortest distances to the unconfirmed neighbors of w
+		for(e = Offset[w]; e < Offset[w+1]; e++)
+		{
+			u = Target[e];
+			if (W[u] != -1 || Weight[e] == FLT_MAX) continue;
+
+			cost_to_u_via_w = ShortestDistance[w] + Weight[e];
+			if (cost_to_u_via_w < ShortestDistance[u]) 
+			{
+				COUNT(Relaxations, 1);
+				/* A vertex already has a cost only if it is queued */
+				if (ShortestDistance[u] == FLT_MAX) {
+					Count.Inserts++;
+					if (++Queued > Count.MaxCount) Count.MaxCount = Queued;
+				}
+				else Count.DecreaseKeys++;
+
+				ShortestDistance[u] = cost_to_u_via_w;
+				Predecessor[u]=w;
+				Item.node = u;
+				Item.weight = cost_to_u_via_w;
+				Ops->Insert(Item, PQ);		//Inserts or moves u up in the queue
+				if (Verbose && w != LSource) 
+				{
+					trace_event(TRACE_RELAX, TRACE_ONE_WAY, u, w, count_added, cost_to_u_via_w);
+				}
+			}
+		}
+	}
+    if (Verbose) trace_event(TRACE_DONE, TRACE_ONE_WAY, -1, -1, count_added, 0);
+
+	if (Stats != NULL) *Stats = Count;
+}
+
+/* Dijkstra's algorithm for weights that graph_weight_scale can make integers.
+ * The vertices are ordered by their scaled integer cost in a radix heap, which
+ * avoids the comparisons of a binary heap.  The distances returned are still
+ * the sums of the original weights.
+ */
+static void RadixSearch(graph_t *G, int LSource, int Verbose, SPWorkspace *WS)
+{
+	int u, w, e, Scale;
+	unsigned long long key_to_u_via_w, *Key;
+	int *W, *Predecessor;
+	double *ShortestDistance;
+	RadixQueue *RQ;
+	RQItem Item;
+
+	Scale = graph_weight_scale(G);
+	if(Scale == 0)
+	{
+		ShortestPathQueueWith(G, &PQBinary, LSource, Verbose, WS, NULL);
+		return;
+	}
+
+	WorkspaceFit(WS, G->NumVert);
+	W = WS_ARRAY(WS, Mark);
+	Key = WS_ARRAY(WS, Key);
+	Predecessor = WS_ARRAY(WS, Pred);
+	ShortestDistance = WS_ARRAY(WS, Dist);
+	if(WS->RQ == NULL) WS->RQ = RQInitialize(WS->Size);
+	RQ = (RadixQueue *) WS->RQ;
+	RQReset(RQ);
+
+	int count_added = 0;	//For verbose prints
+	if (Verbose) trace_event(TRACE_START, TRACE_ONE_WAY, LSource, -1, 0, 0);
+
+	for(u=0; u < G->NumVert; u++) {
+		W[u] = -1;
+		Key[u] = ULLONG_MAX;
+		Predecessor[u] = u;				//Stays u if the vertex is never reached
+		ShortestDistance[u] = FLT_MAX;
+	}
+
+	/* The search starts with only the source in the queue */
+	Key[LSource] = 0;
+	ShortestDistance[LSource] = 0;
+	Item.node = LSource;
+	Item.key = 0;
+	RQInsert(Item, RQ);
+
+	while(!RQEmpty(RQ))
+	{
+		// the vertex w at the front of the queue is the closest unconfirmed one
+		Item = RQRemove(RQ);
+		w = Item.node;
+		W[w] = w;
+		count_added++;
+		COUNT(Settled, 1);
+		COUNT(EdgesScanned, G->EdgeOffset[w+1] - G->EdgeOffset[w]);
+		if (Verbose && w != LSource) {
+			trace_event(TRACE_SETTLE, TRACE_ONE_WAY, w, Predecessor[w], count_added, ShortestDistance[w]);
+		}
+
+		// update the shortest distances to the unconfirmed neighbors of w
+		for(e = G->EdgeOffset[w]; e < G->EdgeOffset[w+1]; e++)
+		{
+			u = G->EdgeTarget[e];
+			if (W[u] != -1 || G->EdgeWeight[e] == FLT_MAX) continue;
+
+			key_to_u_via_w = Key[w] + (unsigned long long) llrint(G->EdgeWeight[e] * Scale);
+			if (key_to_u_via_w < Key[u]) 
+			{
+				COUNT(Relaxations, 1);
+				Key[u] = key_to_u_via_w;
+				ShortestDistance[u] = ShortestDistance[w] + G->EdgeWeight[e];
+				Predecessor[u]=w;
+				Item.node = u;
+				Item.key = key_to_u_via_w;
+				RQInsert(Item, RQ);			//Inserts or moves u to a lower bucket
+				if (Verbose && w != LSource) 
+				{
+					trace_event(TRACE_RELAX, TRACE_ONE_WAY, u, w, count_added, ShortestDistance[u]);
+				}
+			}
+		}
+	}
+    if (Verbose) trace_event(TRACE_DONE, TRACE_ONE_WAY, -1, -1, count_added, 0);
+}
+
+/* The search above, returning arrays that the caller frees */
+void ShortestPathRadix(graph_t *G, int LSource, int Verbose, int **Pred, double **ShDis)
+{
+	SPWorkspace *WS = workspace_construct();
+
+	RadixSearch(G, LSource, Verbose, WS);
+	WorkspaceTake(WS, Pred, ShDis);
+}
+
+/* The delta-stepping search from delta.c, over the arrays of WS */
+static void DeltaSearch(graph_t *G, int LSource, int Verbose, SPWorkspace *WS)
+{
+	graph_finalize(G);
+	WorkspaceFit(WS, G->NumVert);
+	delta_search(G, LSource, WS->Threads, Verbose, WS_ARRAY(WS, Pred), WS_ARRAY(WS, Dist));
+}
+
+/* Runs the shortest path search from LSource with the chosen engine */
+void ShortestPathBy(graph_t *G, int Engine, int LSource, int Verbose, int **Pred, double **ShDis)
+{
+	SPWorkspace *WS = workspace_construct();
+
+	ShortestPathWith(G, Engine, LSource, Verbose, WS);
+	WorkspaceTake(WS, Pred, ShDis);
+}
+
+/* ShortestPathBy into WS.  The results are in WS->Pred and WS->Dist until the
+ * next search with WS.
+ */
+void ShortestPathWith(graph_t *G, int Engine, int LSource, int Verbose, SPWorkspace *WS)
+{
+	if(Engine == SP_AUTO) Engine = graph_pick_engine(G);
+
+	switch(Engine) {
+		case SP_RADIX:
+			RadixSearch(G, LSource, Verbose, WS);
+			break;
+		case SP_HEAP:
+			ShortestPathQueueWith(G, &PQBinary, LSource, Verbose, WS, NULL);
+			break;
+		case SP_DHEAP4:
+			ShortestPathQueueWith(G, &PQDHeap4, LSource, Verbose, WS, NULL);
+			break;
+		case SP_DHEAP8:
+			ShortestPathQueueWith(G, &PQDHeap8, LSource, Verbose, WS, NULL);
+			break;
+		case SP_PAIRING:
+			ShortestPathQueueWith(G, &PQPairing, LSource, Verbose, WS, NULL);
+			break;
+		case SP_FIBONACCI:
+			ShortestPathQueueWith(G, &PQFibonacci, LSource, Verbose, WS, NULL);
+			break;
+		case SP_DELTA:
+			DeltaSearch(G, LSource, Verbose, WS);
+			break;
+		default:
+			DenseSearch(G, LSource, Verbose, WS);
+			break;
+	}
+}
+
+/* Prints the shortest path and stores it backwards in ShortPath, which it returns */
+static int* PrintPath(int LSource, int LDest, int Pred[], double ShortDist[], int *ShortPath)
+{
+	int i=0, j=0;
 
-	/* Since arrays can't be of variable size, allocate space for arrays */
-	//Add one more for an integer to act as an ending point
-	ShortPath = (int *) malloc(G->NumVert * sizeof(int));
 	i=LDest;
 
 	/* Loop to put shortest path between points into its own array */
@@ -334,6 +1721,24 @@ int* PrintShortestPath(graph_t *G, int LSource, int LDest, int Pred[], double Sh
 	return ShortPath;						//Only used for command 3
 }
 
+int* PrintShortestPath(graph_t *G, int LSource, int LDest, int Pred[], double ShortDist[])
+{
+	/* Since arrays can't be of variable size, allocate space for arrays */
+	return PrintPath(LSource, LDest, Pred, ShortDist, (int *) malloc(G->NumVert * sizeof(int)));
+}
+
+/* PrintShortestPath for the last search with WS, which must have been of G.
+ * The path is kept in WS->Path until the next call, instead of in a new array. */
+int* PrintShortestPathWith(graph_t *G, int LSource, int LDest, SPWorkspace *WS)
+{
+	if(LSource < 0 || LSource >= G->NumVert || LDest < 0 || LDest >= G->NumVert || WS->Size < G->NumVert)
+	{
+		fprintf(stderr, "cannot print the path from %d to %d of a search over %d vertices\n", LSource, LDest, WS->Size);
+		exit(1);
+	}
+	return PrintPath(LSource, LDest, WS->Pred, WS->Dist, WS_ARRAY(WS, Path));
+}
+
 
 
 
@@ -8,9 +8,30 @@
  */
 
 
+#include <stdint.h>
+
 #define TRUE 1
 #define FALSE 0
 
+/* Shortest path engines, chosen with -e in lab6 */
+#define SP_AUTO 0			//Pick one of the engines below from the graph
+#define SP_SCAN 1			//Linear scan for the closest unconfirmed vertex
+#define SP_HEAP 2			//Indexed binary heap from heap2.c
+#define SP_RADIX 3			//Radix heap from radix.c, for integer weights
+#define SP_DHEAP4 4			//4-ary heap from dheap.c
+#define SP_DHEAP8 5			//8-ary heap from dheap.c
+#define SP_PAIRING 6		//Pairing heap from pairing.c
+#define SP_FIBONACCI 7		//Fibonacci heap from fibheap.c
+#define SP_DELTA 8			//Delta-stepping over several threads, from delta.c
+
+/* Methods for a single shortest path query */
+#define PATH_BIDIRECTIONAL 1	//ShortestPathPair, searching from both ends
+#define PATH_SINGLE_SOURCE 2	//ShortestPathBy, searching the whole graph
+#define PATH_STOP_AT_DEST 3		//search.c, stopping once the destination is found
+#define PATH_ASTAR 4			//ShortestPathAStar, guided by the vertex positions
+
+#define MAX_WEIGHT_SCALE 64	//Largest multiplier tried to make weights integers
+
 typedef  struct {
     int node;
 	double xl;
@@ -21,16 +42,105 @@ typedef  struct {
 typedef  struct {
     int      	EdgeCount;
     int      	NumVert;
-    double   	**AdjMatrix;
+	unsigned long Version;			//Goes up with every change to an edge
+    double   	**AdjMatrix;		//NULL when the graph is sparse or uses floats
     GraphItem   **VertArray;
+
+	/* The matrix rows point into one 64-byte aligned block, with each row
+	 * padded to a whole number of cache lines.  With IsFloat the weights are
+	 * stored as floats in AdjMatrixF instead of AdjMatrix. */
+	int			IsFloat;
+	int			MatrixStride;		//Entries from the start of one row to the next
+	float		**AdjMatrixF;
+
+	/* Compressed sparse row form: the out-edges of u are the entries
+	 * EdgeOffset[u] .. EdgeOffset[u+1]-1 of EdgeTarget and EdgeWeight */
+	int			IsSparse;
+	int			CSRValid;			//FALSE if edges changed since graph_finalize
+	int			*EdgeOffset;
+	int			*EdgeTarget;
+	double		*EdgeWeight;
+
+	/* The same edges by destination: the in-edges of v come from RevSource
+	 * [RevOffset[v] .. RevOffset[v+1]-1], built by graph_reverse */
+	int			RevValid;
+	int			*RevOffset;
+	int			*RevSource;
+	double		*RevWeight;
+
+	/* Sparse edges added since the last graph_finalize */
+	int			PendCount;
+	int			PendSize;
+	int			*PendSource;
+	int			*PendDest;
+	double		*PendWeight;
+
+	/* Multiplier that makes every weight an integer, 0 if none, -1 if unknown */
+	int			WeightScale;
+
+	/* Largest cost per unit of distance between the VertArray positions that
+	 * no edge undercuts, 0 if there are no positions, -1 if unknown */
+	double		DistanceScale;
+
+	/* Bucket width of the delta-stepping search, -1 if unknown */
+	double		DeltaWidth;
+
+	/* A graph from graph_load uses the mapped snapshot file in place: the
+	 * positions stay there, and the CSR arrays until graph_finalize rebuilds
+	 * them.  MapBase is NULL for other graphs. */
+	void		*MapBase;
+	size_t		MapSize;
+	int			EdgesMapped;
 } graph_t;
 
+/* Arrays and queues for searches from one source, kept from one search to the
+ * next so that a run of searches allocates nothing after the first.  The
+ * searches ending in "With" leave their results in Pred and Dist, which the
+ * next search with the same workspace overwrites.  A workspace is for one
+ * thread at a time. */
+typedef  struct {
+	int			Size;				//Vertices the arrays have room for
+	int			Threads;			//For SP_DELTA, 0 for one per processor
+	int			*Pred;				//Results of the last search
+	double		*Dist;
+	int			*Path;				//From PrintShortestPathWith
+	int			*Mark;				//Confirmed vertices of the searches over edges
+	uint64_t	*Done;				//Confirmed vertices of the dense search, as bits
+	unsigned long long *Key;		//Integer costs of the radix search
+	int			*BackPred;			//Backward half of ShortestPathPairWith
+	double		*BackDist;
+	int			*BackMark;
+	double		*BackWeight;
+	int			*Order;				//Confirmed vertices of search_construct_with
+	int			*Sub;				//Vertices ShortestPathUpdateWith cut off the
+	int			*Child;				//tree of shortest paths, and that tree
+	int			*Sibling;
+	void		*PQ[2];				//Empty queues of the types in PQType
+	const struct PQOps *PQType[2];
+	void		*RQ;				//Empty radix queue
+} SPWorkspace;
+
 
 
 
 graph_t* graph_construct(int NumVertices);
+graph_t* graph_construct_matrix(int NumVertices, int FloatWeights);
+graph_t* graph_construct_sparse(int NumVertices);
 void graph_destruct(graph_t *G);
 void graph_add_edge(graph_t *G, int LSource, int LDest, double LWeight);
+void graph_set_weight(graph_t *G, int LSource, int LDest, double LWeight);
+double graph_edge_weight(graph_t *G, int LSource, int LDest);
+void graph_finalize(graph_t *G);
+void graph_reverse(graph_t *G);
+int graph_weight_scale(graph_t *G);
+double graph_distance_scale(graph_t *G);
+int graph_pick_engine(graph_t *G);
+
+/* Weight in row i, column j of the matrix, for either weight size */
+static inline double graph_matrix_weight(graph_t *G, int i, int j)
+{
+	return G->IsFloat ? (double) G->AdjMatrixF[i][j] : G->AdjMatrix[i][j];
+}
 
 GraphItem* graph_generate_node(int LSource, int NumVertices);
 
@@ -40,6 +150,30 @@ double weight(int LSource, int LDest);
 double FindMaxElement(double ElementArray[], int ElementCount, int *LDest, int *IsInfinity);
 
 void ShortestPath(graph_t *G, int LSource, int Verbose, int **Pred, double **ShDis);
+void ShortestPathSparse(graph_t *G, int LSource, int Verbose, int **Pred, double **ShDis);
+void ShortestPathHeap(graph_t *G, int LSource, int Verbose, int **Pred, double **ShDis);
+struct PQOps;
+struct PQStats;
+void ShortestPathQueue(graph_t *G, const struct PQOps *Ops, int LSource, int Verbose, int **Pred, double **ShDis, struct PQStats *Stats);
+void ShortestPathRadix(graph_t *G, int LSource, int Verbose, int **Pred, double **ShDis);
+void ShortestPathReverse(graph_t *G, int LDest, int Verbose, int **Succ, double **ShDis);
+void ShortestPathPair(graph_t *G, int LSource, int LDest, int Verbose, int **Pred, double **ShDis);
+void ShortestPathAStar(graph_t *G, int LSource, int LDest, int Verbose, int **Pred, double **ShDis);
+void ShortestPathUpdate(graph_t *G, int LSource, int Count, const int *LFrom, const int *LTo, const double *LWeight,
+						int *Pred, double *ShDis);
+void ShortestPathBy(graph_t *G, int Engine, int LSource, int Verbose, int **Pred, double **ShDis);
+
+SPWorkspace* workspace_construct(void);
+void workspace_destruct(SPWorkspace *WS);
+void* workspace_prepare(SPWorkspace *WS, int NumVert, const struct PQOps *Ops);
+void ShortestPathWith(graph_t *G, int Engine, int LSource, int Verbose, SPWorkspace *WS);
+void ShortestPathQueueWith(graph_t *G, const struct PQOps *Ops, int LSource, int Verbose, SPWorkspace *WS, struct PQStats *Stats);
+void ShortestPathReverseWith(graph_t *G, int LDest, int Verbose, SPWorkspace *WS);
+void ShortestPathPairWith(graph_t *G, int LSource, int LDest, int Verbose, SPWorkspace *WS);
+void ShortestPathAStarWith(graph_t *G, int LSource, int LDest, int Verbose, SPWorkspace *WS);
+void ShortestPathUpdateWith(graph_t *G, int LSource, int Count, const int *LFrom, const int *LTo, const double *LWeight,
+							SPWorkspace *WS);
 
 int* PrintShortestPath(graph_t *G, int LSource, int LDest, int Pred[], double ShortDist[]);
+int* PrintShortestPathWith(graph_t *G, int LSource, int LDest, SPWorkspace *WS);
 
@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include "heap.h"
+#include "counters.h"
 
 /*--------------------------------------------------*/
 
@@ -34,10 +35,12 @@ PriorityQueue *PQInitialize(int num_vertices)
     // ItemLocation is a very sparce table if the graph is sparce
     // consider improving implementation to use a hash table
     PQ->ItemLocation = (int *) calloc(num_vertices, sizeof(int));
+    COUNT(BytesAllocated, sizeof(PriorityQueue) + PQ->Size * sizeof(PQItem) + num_vertices * sizeof(int));
     return PQ;
 }
 void PQDestruct(PriorityQueue *PQ)
 {
+    COUNT_PEAK(PQ->MaxCount);
     free(PQ->ItemArray);
     free(PQ->ItemLocation);
     free(PQ);
@@ -79,7 +82,7 @@ void PQInsert(PQItem Item, PriorityQueue *PQ)
     int  ParentLoc;                          /* parent of current child */
 
     assert(Item.node >=0 && Item.node < PQ->NumVertices);
-    assert(Item.weight > 0.0);
+    assert(Item.weight >= 0.0);      // the source vertex is inserted at 0
 
     if (PQFull(PQ)) {    // could improve to first check if found
         printf("Call to Full failed!\n");
@@ -88,8 +91,10 @@ void PQInsert(PQItem Item, PriorityQueue *PQ)
     // If the Item is already in heap then update
     if (PQ->ItemLocation[Item.node] != 0) {
         ChildLoc = PQ->ItemLocation[Item.node];
+        COUNT(DecreaseKeys, 1);
     }
     else {
+        COUNT(Inserts, 1);
         (PQ->Count)++;
         ChildLoc = PQ->Count;
         if (PQ->Count > PQ->MaxCount) PQ->MaxCount = PQ->Count;
@@ -131,6 +136,7 @@ PQItem PQRemove(PriorityQueue *PQ)
     }
 
     /* Initializations */
+    COUNT(Removes, 1);
     ItemToReturn = PQ->ItemArray[1];        /* value to return later */
     ItemToPlace = PQ->ItemArray[PQ->Count];     /* last leaf's value */
     (PQ->Count)--;                /* delete last leaf in level order */
@@ -16,14 +16,67 @@
  *	 -n N			number of vertices in graph
  *	 -a 0<R<N		number of vertices in graph
  * 
- *	 -h 1|2|3		graph operation (default 1)
+ *	 -h 1-7			graph operation (default 1)
  *	 -h 1			Shortest path from vertex S to vertex D
  *	 -h 2			Network diameter of graph
  *	 -h 3			Multiple link-disjoint paths from vertex S to vertex D
+ *	 -h 4			Compare the priority queues on the graph
+ *	 -h 5			Vertices nearest to vertex S
+ *	 -h 6			K link-disjoint paths from S to D with the least total cost
+ *	 -h 7			Shortest paths for many S D pairs, read from -b
  * 
  *	 -s 0<=S<N		number of the source vertex
  *	 -d 0<=D<N		number of the destination vertex
- *	 -v				turn on verbose prints (default off)
+ *	 -v				turn on verbose prints (default off); the steps of the
+ *					searches are printed once the operation is done, up to
+ *					the last TRACE_EVENTS of them
+ *	 -S				store the graph in compressed sparse row form (default for -g 4)
+ *	 -M				store the graph as an adjacency matrix (default for -g 1|2|3)
+ *	 -F				store the matrix weights as 32-bit floats instead of doubles
+ *	 -e 0-8			shortest path engine (default 0)
+ *	 -e 0			Chosen from the graph
+ *	 -e 1			Linear scan for the closest vertex
+ *	 -e 2			Binary heap priority queue
+ *	 -e 3			Radix heap, for graphs with integer weights
+ *	 -e 4|5			4-ary or 8-ary heap priority queue
+ *	 -e 6			Pairing heap priority queue
+ *	 -e 7			Fibonacci heap priority queue
+ *	 -e 8			Delta-stepping, spread over -t threads
+ *	 -t T			threads for all-source commands and -e 8 (default 0, one per core)
+ *	 -m M			method for the graph operation (default 1)
+ *	 -h 1 -m 1		Shortest path by a search from both ends at once
+ *	 -h 1 -m 2		Shortest path by a search from the source with -e
+ *	 -h 1 -m 3		Shortest path by a search that stops at the destination
+ *	 -h 1 -m 4		Shortest path by A*, using the vertex positions of -g 4
+ *	 -h 2 -m 1		Network diameter by a search from every vertex
+ *	 -h 2 -m 2		Network diameter by eccentricity bounds; -v also
+ *					finds and prints every eccentricity
+ *	 -h 2 -m 3		Network diameter by Floyd-Warshall, for dense graphs
+ *	 -h 3 -m 1		Link-disjoint paths by removing each shortest path in turn
+ *	 -h 3 -m 2		Link-disjoint paths by maximum flow; finds the most paths
+ *	 -h 3 -m 3		Like -m 1, but repairs the search after removing each path
+ *	 -h 5 -m 1		The K nearest vertices to S
+ *	 -h 5 -m 2		Every vertex within distance W of S
+ *	 -k K			number of vertices for -h 5 -m 1 (default 5),
+ *					or of paths for -h 6 (default 2)
+ *	 -w W			distance for -h 5 -m 2 (default 1)
+ *	 -b FILE		file of "S D" lines for -h 7, - for stdin (default -)
+ *	 -C MB			memory for searches kept between chunks of -h 7 (default 64)
+ *	 -o FILE		save the graph to a snapshot file after building it
+ *	 -l FILE		load the graph from a snapshot file instead of building
+ *					one; -g, -n, -a, -S, -M and -F are ignored
+ *	 -f FILE		read the graph from a DIMACS .gr file or an edge list of
+ *					"U V [W]" lines instead of building one, with -t threads
+ *	 -R N			time N runs of the operation and print the median and
+ *					95th percentile wall times
+ *	 -W N			untimed warm-up runs before the timed ones (default 0)
+ *	 -B FILE		add the timings to a CSV file, as bench.sh does
+ *	 -J FILE		add the counts of edges scanned, relaxations, queue
+ *					operations and bytes allocated by the build and the
+ *					operation to FILE as JSON lines; needs make COUNTERS=1,
+ *					which also prints them
+ *	 -T FILE		write every step of the searches to a binary trace file,
+ *					printed with ./tracedump FILE; implies -v
  *	 -r 1234567		seed for random number generator
  *	 -p				turns on debug print (added for personal use)
  *
@@ -41,6 +94,17 @@
 #include <float.h>
 
 #include "graph.h"
+#include "heap.h"
+#include "pqueue.h"
+#include "apsp.h"
+#include "delta.h"
+#include "search.h"
+#include "flow.h"
+#include "cache.h"
+#include "snapshot.h"
+#include "reader.h"
+#include "counters.h"
+#include "trace.h"
 
 /* Global variables for command line parameters */
 int GraphType = 1;
@@ -51,10 +115,37 @@ int NumberOfSourceVertex = 0;
 int NumberOfDestinationVertex = 0;
 int Verbose = FALSE;
 int Printer = FALSE;
+int Sparse = -1;						//Unset: only random graphs are sparse
+int FloatWeights = FALSE;
+int Engine = SP_AUTO;
+int Threads = 0;
+int Method = 0;
+int KCount = 0;							//-k, 0 for the operation's default
+double Radius = 1.0;
+char *BatchFile = "-";
+int CacheMB = 64;
+char *SaveFile = NULL;
+char *LoadFile = NULL;
+char *ReadFile = NULL;
+int BenchRuns = 0;						//-R, 0 unless benchmarking
+int BenchWarmups = 0;
+char *BenchFile = NULL;
+char *CountersFile = NULL;
+char *TraceFile = NULL;
 int Seed = 10212018;
 
+/* Names of the -h operations in the counter reports */
+const char *OperationName[] = {"none", "shortest_path", "diameter", "link_disjoint", "queues",
+							   "nearest", "cheapest_link_disjoint", "batch"};
+
+/* What each -h operation's throughput is counted in, and how many of them
+ * the last run of the operation did */
+const char *OperationUnit[] = {"runs", "queries", "sources", "runs", "runs", "queries", "runs", "queries"};
+long OperationItems = 1;
+
 /* Local functions */
 void getCommandLine(int argc, char **argv);
+void CheckEndpoints(void);
 void debug_print_graph(graph_t *G);
 void AdjacencyPrint(graph_t *G);
 
@@ -66,6 +157,16 @@ void RandGraphFunc(graph_t *G);
 void ShortestPathCommand(graph_t *G);
 void NetworkDiameterCommand(graph_t *G);
 void MultLinkCommand(graph_t *G);
+void QueueBenchCommand(graph_t *G);
+void NearestCommand(graph_t *G);
+void CheapLinkCommand(graph_t *G);
+void PrintLinkPaths(LinkPaths *P);
+void BatchCommand(graph_t *G);
+void BenchCommand(graph_t **G);
+graph_t* BuildGraph(void);
+void RunOperation(graph_t *G);
+double WallMs(void);
+void ReportCounters(const char *Name);
 
 
 int main(int argc, char **argv)
@@ -74,30 +175,82 @@ int main(int argc, char **argv)
 
 	getCommandLine(argc, argv);
 	printf("Seed: %d\n", Seed);
-	srand48(Seed);
+	if(TraceFile != NULL) trace_open(TraceFile);
 
-	G=graph_construct(NumberOfVertices);
+	G = BuildGraph();
+	ReportCounters("build");
+	if(SaveFile != NULL) graph_save(G, GraphType, SaveFile);
 
-	switch(GraphType) {
-		case 1: 
-			WeakConnectFunc(G);
-			printf("\nWeakly-connected directed graph\n");
-			break;
-		case 2: 
-			DirectSymFunc(G);
-			printf("\nDirected graph with symmetric weights\n");
-			break;
-		case 3: 
-			StrongConnectFunc(G);
-			printf("\nStrongly-connected directed graph with %d vertices\n", NumberOfVertices);
-			break;
-		case 4: 
-			RandGraphFunc(G);
-			break;
-		default: 
-			fprintf(stderr, "invalid graph type: %d\n", GraphType);
-			exit(1);
-		}
+	if(BenchRuns > 0 || BenchWarmups > 0 || BenchFile != NULL) BenchCommand(&G);
+	else RunOperation(G);
+
+	if(Printer)
+		debug_print_graph(G);
+
+	graph_destruct(G);		//Must destroy graph when done
+	trace_close();
+	return 0;
+}
+
+/* Builds the graph from -l, -f or -g.  Generated graphs start from the same
+ * seed every time, so calling this again gives the same graph.
+ */
+graph_t* BuildGraph(void)
+{
+	graph_t *G;
+
+	srand48(Seed);
+	if(LoadFile != NULL)
+	{
+		G=graph_load(LoadFile, &GraphType);
+		NumberOfVertices = G->NumVert;
+		CheckEndpoints();
+		printf("\nLoaded graph of type %d with %d vertices and %d edges from %s\n",
+				GraphType, NumberOfVertices, G->EdgeOffset[NumberOfVertices], LoadFile);
+	}
+	else if(ReadFile != NULL)
+	{
+		G=graph_read(ReadFile, apsp_thread_count(Threads));
+		GraphType = 0;							//None of the generated types
+		NumberOfVertices = G->NumVert;
+		CheckEndpoints();
+		printf("\nRead graph with %d vertices and %d edges from %s\n",
+				NumberOfVertices, G->EdgeOffset[NumberOfVertices], ReadFile);
+	}
+	else
+	{
+		if(Sparse < 0) Sparse = (GraphType == 4);
+		if(Sparse) G=graph_construct_sparse(NumberOfVertices);
+		else G=graph_construct_matrix(NumberOfVertices, FloatWeights);
+
+		switch(GraphType) {
+			case 1: 
+				WeakConnectFunc(G);
+				printf("\nWeakly-connected directed graph\n");
+				break;
+			case 2: 
+				DirectSymFunc(G);
+				printf("\nDirected graph with symmetric weights\n");
+				break;
+			case 3: 
+				StrongConnectFunc(G);
+				printf("\nStrongly-connected directed graph with %d vertices\n", NumberOfVertices);
+				break;
+			case 4: 
+				RandGraphFunc(G);
+				break;
+			default: 
+				fprintf(stderr, "invalid graph type: %d\n", GraphType);
+				exit(1);
+			}
+	}
+	return G;
+}
+
+/* Runs the operation chosen with -h on G */
+void RunOperation(graph_t *G)
+{
+	OperationItems = 1;					//Unless the command counts its own
 
 	/* Command switch case */
 	switch (GraphOperation) {
@@ -118,13 +271,58 @@ int main(int argc, char **argv)
 			printf("\nMultiple link-disjoint paths\n");
 			MultLinkCommand(G);
 			break;
-	}
 
-	if(Printer)
-		debug_print_graph(G);
+		/* Priority queue comparison */
+		case 4:
+			printf("\nPriority queue comparison\n");
+			QueueBenchCommand(G);
+			break;
 
-	graph_destruct(G);		//Must destroy graph when done
-	return 0;
+		/* Nearest vertices command */
+		case 5:
+			printf("\nNearest vertices\n");
+			NearestCommand(G);
+			break;
+
+		/* Cheapest link-disjoint paths command */
+		case 6:
+			printf("\nCheapest link-disjoint paths\n");
+			CheapLinkCommand(G);
+			break;
+
+		/* Batch query command */
+		case 7:
+			printf("\nBatch shortest paths\n");
+			BatchCommand(G);
+			break;
+	}
+	if(Verbose) trace_print(stdout);		//The steps are kept until the operation is done
+	ReportCounters(OperationName[GraphOperation]);
+}
+
+/* Prints the counters from counters.h since the last report, and adds them to
+ * the -J file.  Does nothing unless built with make COUNTERS=1.
+ */
+void ReportCounters(const char *Name)
+{
+#ifdef COUNTERS
+	counters_t C;
+	FILE *Out;
+
+	counters_take(&C);
+	printf("Counters for %s\n", Name);
+	counters_print(&C);
+	if(CountersFile != NULL)
+	{
+		if((Out = fopen(CountersFile, "a")) == NULL)
+		{
+			fprintf(stderr, "cannot open counters file: %s\n", CountersFile);
+			exit(1);
+		}
+		counters_json(Out, Name, &C);
+		fclose(Out);
+	}
+#endif
 }
 
 
@@ -207,10 +405,17 @@ void StrongConnectFunc(graph_t *G)
 }
 
 
-/* Function for setting up random graph */
+/* Function for setting up random graph.
+ *
+ * The vertices are sorted into a grid of square cells at least VertRad wide,
+ * so the neighbors of a vertex can only be in its own cell or the 8 around
+ * it.  Only those cells are checked, which takes O(V*a) time instead of
+ * O(V^2).
+ */
 void RandGraphFunc(graph_t *G)
 {
 	int i, link_src, link_dest, TempMax, TempMin, TempAvg;
+	int Cells, cx, cy, x, y, c, *CellStart, *CellVert, *VertCell;
 	double distance, VertRad, MinDatRate, MaxDatRate;
 
 	GraphItem *NewItem;
@@ -229,30 +434,62 @@ void RandGraphFunc(graph_t *G)
 	//Find minimum data rate for later
 	MinDatRate=log10(1+((1/VertRad)*(1/VertRad)));
 
+	/* Sort the vertices by cell, counting the vertices in each cell first */
+	Cells = (VertRad < 1) ? (int) (1 / VertRad) : 1;
+	if(Cells > 4096) Cells = 4096;				//Wider cells are still correct
+	CellStart = (int *) calloc(Cells * Cells + 1, sizeof(int));
+	CellVert = (int *) malloc(NumberOfVertices * sizeof(int));
+	VertCell = (int *) malloc(NumberOfVertices * sizeof(int));
+	for(i = 0; i < NumberOfVertices; i++)
+	{
+		cx = (int) (G->VertArray[i]->xl * Cells);
+		cy = (int) (G->VertArray[i]->yl * Cells);
+		if(cx >= Cells) cx = Cells - 1;			//Points on the far edge
+		if(cy >= Cells) cy = Cells - 1;
+		VertCell[i] = cy * Cells + cx;
+		CellStart[VertCell[i] + 1]++;
+	}
+	for(c = 0; c < Cells * Cells; c++) CellStart[c+1] += CellStart[c];
+	for(i = 0; i < NumberOfVertices; i++) CellVert[CellStart[VertCell[i]]++] = i;
+	for(c = Cells * Cells; c > 0; c--) CellStart[c] = CellStart[c-1];
+	CellStart[0] = 0;
+
 	/* Loop to add appropriate edges for each vertex */
 	for(link_src = 0; link_src < NumberOfVertices; link_src++)
 	{ 
-		for(link_dest = 0; link_dest < NumberOfVertices; link_dest++) 
+		cx = VertCell[link_src] % Cells;
+		cy = VertCell[link_src] / Cells;
+		for(y = cy - 1; y <= cy + 1; y++)
 		{
-			if(link_src == link_dest) continue;
-
-			/* Functions for finding weight */
-			//Find distance between points first
-			distance=vertex_distance(G->VertArray[link_src], G->VertArray[link_dest]);
-
-			//Weight for edge depends on following
-			if(distance <= VertRad)
+			for(x = cx - 1; x <= cx + 1; x++)
 			{
-				//Find maximum data rate
-				MaxDatRate=maximum_data(distance, VertRad);
-				graph_add_edge(G, link_src, link_dest, MinDatRate/MaxDatRate);
-
-				/* Count up adjacent edges */
-				G->VertArray[link_src]->adjvert=G->VertArray[link_src]->adjvert+1;
+				if(x < 0 || y < 0 || x >= Cells || y >= Cells) continue;
+				c = y * Cells + x;
+				for(i = CellStart[c]; i < CellStart[c+1]; i++) 
+				{
+					link_dest = CellVert[i];
+					if(link_src == link_dest) continue;
+
+					/* Functions for finding weight */
+					//Find distance between points first
+					distance=vertex_distance(G->VertArray[link_src], G->VertArray[link_dest]);
+
+					//Weight for edge depends on following
+					if(distance <= VertRad)
+					{
+						//Find maximum data rate
+						MaxDatRate=maximum_data(distance, VertRad);
+						graph_add_edge(G, link_src, link_dest, MinDatRate/MaxDatRate);
+
+						/* Count up adjacent edges */
+						G->VertArray[link_src]->adjvert=G->VertArray[link_src]->adjvert+1;
+					}
+				}
 			}
-			else graph_add_edge(G, link_src, link_dest, FLT_MAX);
 		}
 	}
+	free(CellStart); free(CellVert); free(VertCell);
+	graph_finalize(G);
 	printf("\nRandom graph with %d vertices\n", NumberOfVertices);
 
 	TempMax = G->VertArray[0]->adjvert;
@@ -282,64 +519,101 @@ void RandGraphFunc(graph_t *G)
 
 /* --------------------FUNCTIONS FOR GRAPH OPERATIONS-------------------- */
 
+/* Milliseconds on the monotonic clock, which counts wall time across threads
+ * and doesn't jump when the system time is set */
+double WallMs(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return 1000.0 * t.tv_sec + t.tv_nsec / 1e6;
+}
+
 /* Function for the Shortest Path Command */
 void ShortestPathCommand(graph_t *G)
 {
-	int *Pred, *TempPred;
-	double *ShortDist;
-	clock_t start, end;
+	double start, end;
+	search_t *S = NULL;
+	SPWorkspace *WS;
+
+	/* Every method leaves its path in the arrays of WS */
+	WS = workspace_construct();
+	WS->Threads = Threads;
 
 	/* Timer for the Dijkstra function */
-	start = clock();
-	ShortestPath(G, NumberOfSourceVertex, Verbose, &Pred, &ShortDist);
-	end = clock();
+	start = WallMs();
+	if(Method == PATH_SINGLE_SOURCE)
+		ShortestPathWith(G, Engine, NumberOfSourceVertex, Verbose, WS);
+	else if(Method == PATH_STOP_AT_DEST)
+	{
+		S = search_construct_with(G, NULL, NumberOfSourceVertex, WS);
+		search_until(S, NumberOfDestinationVertex);
+		if(Verbose) printf("Confirmed %d nodes, including source\n", S->Settled);
+	}
+	else if(Method == PATH_ASTAR)
+		ShortestPathAStarWith(G, NumberOfSourceVertex, NumberOfDestinationVertex, Verbose, WS);
+	else
+		ShortestPathPairWith(G, NumberOfSourceVertex, NumberOfDestinationVertex, Verbose, WS);
+	end = WallMs();
 
-	TempPred=PrintShortestPath(G, NumberOfSourceVertex, NumberOfDestinationVertex, Pred, ShortDist);
+	PrintShortestPathWith(G, NumberOfSourceVertex, NumberOfDestinationVertex, WS);
 
-	free(Pred); free(ShortDist); free(TempPred);	//Free allocated arrays
+	/* The search borrows the arrays of WS, so it goes first */
+	if(S != NULL) search_destruct(S);
+	workspace_destruct(WS);
 
 	printf("After ShortestPath command on a graph with %d vertices,", NumberOfVertices);
-	printf("\ntime = %g ms\n\n", 1000*((double)(end-start))/CLOCKS_PER_SEC);
+	printf("\ntime = %g ms\n\n", end-start);
 }
 
 
 /* Function for the Network Diameter Command */
 void NetworkDiameterCommand(graph_t *G)
 {
-	int i, j=-1, LSource=-2, LDest=-1, IsInfinity=0, *Pred, *TempPred;
-	double MaxElem, TempMax, *ShortDist, *TempShort;
-	clock_t start, end;
-
-	MaxElem =-1;
-	ShortestPath(G, 0, Verbose, &Pred, &ShortDist);		//First case
+	int i;
+	double start, end;
+	DiameterResult R;
+	SPWorkspace *WS;
 
 	/* Timer to measure how long the actual command takes */
-	start = clock();
-	for(i=0; i < G->NumVert; i++)
+	start = WallMs();
+	if(Method == DIAM_BOUNDING) BoundingDiameter(G, Engine, Threads, Verbose, &R);
+	else if(Method == DIAM_FLOYD) FloydDiameter(G, &R);
+	else AllSourcesDiameter(G, Engine, Threads, Verbose, &R);
+	end = WallMs();
+	OperationItems = (Method == DIAM_FLOYD) ? G->NumVert : R.Searches;	//Floyd solves every source at once
+
+	/* Only the source of the longest path needs its path rebuilt, unless
+	 * the method kept it */
+	if(R.PathPred != NULL) free(PrintShortestPath(G, R.Source, R.Dest, R.PathPred, R.PathDist));
+	else
 	{
-		ShortestPath(G, i, Verbose, &TempPred, &TempShort);
-		TempMax = FindMaxElement(TempShort, NumberOfVertices, &j, &IsInfinity);
+		WS = workspace_construct();
+		WS->Threads = Threads;
+		ShortestPathWith(G, Engine, R.Source, FALSE, WS);
+		PrintShortestPathWith(G, R.Source, R.Dest, WS);
+		workspace_destruct(WS);
+	}
+
+	if(R.IsInfinity) printf("There is at least one path without a connection.\n");
+	else printf("The radius is %.2f, with center %d\n", R.Radius, R.Center);
+	if(Method == DIAM_BOUNDING)
+		printf("Searches run: %d to prove the diameter, %d in all\n", R.DiameterSearches, R.Searches);
 
-		//Update max value, source, dest, and paths if a larger max is found
-		if(MaxElem < TempMax)
+	/* Print the eccentricities, or their bounds if they weren't all needed */
+	if(Verbose)
+	{
+		printf("\nEccentricities\n");
+		for(i = 0; i < G->NumVert; i++)
 		{
-			MaxElem = TempMax;
-			free(Pred); free(ShortDist);		//Must be freed before being replaced
-			ShortestPath(G, i, Verbose, &Pred, &ShortDist);
-			LSource = i;
-			LDest = j;
+			if(R.Ecc[i] == FLT_MAX) printf("Vertex %d: INF\n", i);
+			else if(R.EccLow[i] == R.Ecc[i]) printf("Vertex %d: %.2f\n", i, R.Ecc[i]);
+			else printf("Vertex %d: between %.2f and %.2f\n", i, R.EccLow[i], R.Ecc[i]);
 		}
-		free(TempPred); free(TempShort);
 	}
-	end = clock();
-
-	TempPred = PrintShortestPath(G, LSource, LDest, Pred, ShortDist);
-	free(Pred);free(ShortDist);free(TempPred);
+	diameter_result_free(&R);
 
-	if(IsInfinity > 0) printf("There is at least one path without a connection.\n");
-
-	printf("After NetworkDiameter command on a graph with %d vertices,", NumberOfVertices);
-	printf("\ntime = %g ms\n\n", 1000*((double)(end-start))/CLOCKS_PER_SEC);
+	printf("After NetworkDiameter command on a graph with %d vertices using %d threads,", NumberOfVertices, apsp_thread_count(Threads));
+	printf("\ntime = %g ms\n\n", end-start);
 }
 
 
@@ -349,15 +623,35 @@ void NetworkDiameterCommand(graph_t *G)
 /* Function for the Multiple Link-Disjoint Command */
 void MultLinkCommand(graph_t *G)
 {
-	int n=0, *Pred, *TempPred;
-	double *ShortDist;
-	clock_t start, end;
+	int n=0, *TempPred, *CutFrom, *CutTo;
+	double *CutWeight;
+	double start, end;
+	LinkPaths *P;
+	SPWorkspace *WS;
 
 	/* Timer to measure how long the actual command takes */
-	start = clock();
-	/* Initial path find */
-	ShortestPath(G, NumberOfSourceVertex, Verbose, &Pred, &ShortDist);
-	TempPred=PrintShortestPath(G, NumberOfSourceVertex, NumberOfDestinationVertex, Pred, ShortDist);
+	start = WallMs();
+	if(Method == LINK_MAX_FLOW)
+	{
+		P = DisjointPaths(G, NumberOfSourceVertex, NumberOfDestinationVertex);
+		end = WallMs();
+
+		PrintLinkPaths(P);
+		printf("After Multiple link-disjoint command with %d vertices,", NumberOfVertices);
+		printf("\ntime = %g ms\n\n", end-start);
+		link_paths_free(P);
+		return;
+	}
+
+	CutFrom = (int *) malloc(G->NumVert * sizeof(int));
+	CutTo = (int *) malloc(G->NumVert * sizeof(int));
+	CutWeight = (double *) malloc(G->NumVert * sizeof(double));
+
+	/* Initial path find; every search and path reuses the arrays of WS */
+	WS = workspace_construct();
+	WS->Threads = Threads;
+	ShortestPathWith(G, Engine, NumberOfSourceVertex, Verbose, WS);
+	TempPred=PrintShortestPathWith(G, NumberOfSourceVertex, NumberOfDestinationVertex, WS);
 
 	//Stop looping when there are no more paths to the destination
 	while(TempPred[0] != NumberOfSourceVertex && TempPred[0] != FLT_MAX)
@@ -366,22 +660,408 @@ void MultLinkCommand(graph_t *G)
 		/* Loop to remove edges on the previous path */
 		while(TempPred[n] != NumberOfSourceVertex && TempPred[n] != FLT_MAX)
 		{
-			G->AdjMatrix[TempPred[n+1]][TempPred[n]]=FLT_MAX;	//Set path to infinity
+			if(Method == LINK_REPAIR)			//Saved to be removed all at once
+			{
+				CutFrom[n] = TempPred[n+1];
+				CutTo[n] = TempPred[n];
+				CutWeight[n] = FLT_MAX;
+			}
+			else
+				graph_set_weight(G, TempPred[n+1], TempPred[n], FLT_MAX);	//Set path to infinity
 			n++;
 		}
 
-		free(Pred); free(ShortDist); free(TempPred);	//Free allocated arrays before using again
+		/* Set the path to infinity and fix the search to match */
+		if(Method == LINK_REPAIR)
+			ShortestPathUpdateWith(G, NumberOfSourceVertex, n, CutFrom, CutTo, CutWeight, WS);
 
 		//Get new path
-		ShortestPath(G, NumberOfSourceVertex, Verbose, &Pred, &ShortDist);
-		TempPred=PrintShortestPath(G,NumberOfSourceVertex,NumberOfDestinationVertex,Pred,ShortDist);
+		if(Method != LINK_REPAIR)
+			ShortestPathWith(G, Engine, NumberOfSourceVertex, Verbose, WS);
+		TempPred=PrintShortestPathWith(G,NumberOfSourceVertex,NumberOfDestinationVertex,WS);
 	}
 
-	end = clock();
+	end = WallMs();
 	printf("After Multiple link-disjoint command with %d vertices,", NumberOfVertices);
-	printf("\ntime = %g ms\n\n", 1000*((double)(end-start))/CLOCKS_PER_SEC);
-	free(Pred); free(ShortDist); free(TempPred);		//Final free of allocated arrays
+	printf("\ntime = %g ms\n\n", end-start);
+	workspace_destruct(WS);		//Final free of allocated arrays
+	free(CutFrom); free(CutTo); free(CutWeight);
+
+}
+
+
+
+
+
+
+
+/* Function for the Cheapest Link-disjoint Paths Command */
+void CheapLinkCommand(graph_t *G)
+{
+	double start, end;
+	LinkPaths *P;
+
+	start = WallMs();
+	P = CheapestDisjointPaths(G, NumberOfSourceVertex, NumberOfDestinationVertex, KCount > 0 ? KCount : 2);
+	end = WallMs();
+
+	PrintLinkPaths(P);
+	printf("After Cheapest link-disjoint command with %d vertices,", NumberOfVertices);
+	printf("\ntime = %g ms\n\n", end-start);
+	link_paths_free(P);
+}
+
+/* Prints each of the paths in P, then how many there are and their total cost */
+void PrintLinkPaths(LinkPaths *P)
+{
+	int i, k;
+	double Total = 0;
+
+	for(i = 0; i < P->NumPaths; i++)
+	{
+		printf("\nThe cost of the path between %d and %d is %.2f\n", NumberOfSourceVertex, NumberOfDestinationVertex, P->Cost[i]);
+		for(k = P->Start[i]; k < P->Start[i+1] - 1; k++) printf("%d -- ", P->Vert[k]);
+		printf("%d\n", P->Vert[k]);
+		Total += P->Cost[i];
+	}
+	printf("\nFound %d link-disjoint paths between %d and %d, with a total cost of %.2f\n",
+			P->NumPaths, NumberOfSourceVertex, NumberOfDestinationVertex, Total);
+}
+
+
+/* Function for the Batch Query Command.  Pairs of source and destination
+ * vertices are read from BatchFile ("-" for stdin), BATCH_CHUNK at a time.
+ * Within a chunk the queries are grouped by source so that one search serves
+ * every destination of that source.  The searches are kept in a cache of
+ * CacheMB megabytes, so a source that comes up again in a later chunk costs
+ * nothing; a source asked for only once and not cached gets the
+ * bidirectional search instead.  Each answer is one line, in the order the
+ * queries came in:
+ *		S D cost V0 V1 ... Vk		or		S D inf
+ */
+#define BATCH_CHUNK 4096
+
+/* Source of each query in the chunk, for CompareSource */
+static int *BatchSource;
+
+/* Orders query numbers by source, then by number */
+static int CompareSource(const void *a, const void *b)
+{
+	int i = *(const int *) a, j = *(const int *) b;
+
+	if(BatchSource[i] != BatchSource[j]) return BatchSource[i] - BatchSource[j];
+	return i - j;
+}
+
+void BatchCommand(graph_t *G)
+{
+	int i, j, k, q, v, c, Count, Line = 0, Queries = 0, Searches = 0;
+	int *Src, *Dst, *Order, *PathStart, *PathEnd, *PathVert, *Pred, Used, Size, Single;
+	double *Cost, *ShortDist;
+	char Text[256];
+	double start, end;
+	FILE *In;
+	tree_cache_t *Cache;
+	SPWorkspace *WS;
+
+	if(strcmp(BatchFile, "-") == 0) In = stdin;
+	else if((In = fopen(BatchFile, "r")) == NULL)
+	{
+		fprintf(stderr, "cannot open query file: %s\n", BatchFile);
+		exit(1);
+	}
+
+	Src = (int *) malloc(BATCH_CHUNK * sizeof(int));
+	Dst = (int *) malloc(BATCH_CHUNK * sizeof(int));
+	Order = (int *) malloc(BATCH_CHUNK * sizeof(int));
+	Cost = (double *) malloc(BATCH_CHUNK * sizeof(double));
+	PathStart = (int *) malloc(BATCH_CHUNK * sizeof(int));
+	PathEnd = (int *) malloc(BATCH_CHUNK * sizeof(int));
+	Size = G->NumVert + 1;					//Grown when the paths of a chunk need more
+	PathVert = (int *) malloc(Size * sizeof(int));
+	graph_finalize(G);						//Not part of any query's time
+	Cache = tree_cache_construct(G, Engine, (size_t) CacheMB << 20);
+	WS = workspace_construct();			//For the searches not worth caching
+	WS->Threads = Threads;
+
+	start = WallMs();
+	while(TRUE)
+	{
+		/* Read the next chunk of queries, skipping lines that aren't one */
+		for(Count = 0; Count < BATCH_CHUNK && fgets(Text, sizeof(Text), In) != NULL; )
+		{
+			Line++;
+			if(strchr(Text, '\n') == NULL)			//Only the start of a long line is read
+				while((c = getc(In)) != EOF && c != '\n')
+					;
+			if(sscanf(Text, "%d %d", &Src[Count], &Dst[Count]) != 2) continue;
+			if(Src[Count] < 0 || Src[Count] >= G->NumVert || Dst[Count] < 0 || Dst[Count] >= G->NumVert)
+			{
+				fprintf(stderr, "query on line %d is outside the graph: %d %d\n", Line, Src[Count], Dst[Count]);
+				continue;
+			}
+			Order[Count] = Count;
+			Count++;
+		}
+		if(Count == 0) break;
+		Queries += Count;
+
+		BatchSource = Src;
+		qsort(Order, Count, sizeof(int), CompareSource);
+
+		/* One search for each source, answering all of its queries.  The
+		 * paths are stored backwards, PathStart[q] .. PathEnd[q]-1 */
+		Used = 0;
+		for(i = 0; i < Count; i = j)
+		{
+			for(j = i + 1; j < Count && Src[Order[j]] == Src[Order[i]]; j++)
+				;
+			Single = (j - i == 1 && !tree_cache_has(Cache, Src[Order[i]]));
+			if(Single)
+			{
+				ShortestPathPairWith(G, Src[Order[i]], Dst[Order[i]], FALSE, WS);
+				Pred = WS->Pred;
+				ShortDist = WS->Dist;
+				Searches++;
+			}
+			else
+				tree_cache_get(Cache, Src[Order[i]], &Pred, &ShortDist);
+
+			for(k = i; k < j; k++)
+			{
+				q = Order[k];
+				Cost[q] = ShortDist[Dst[q]];
+				PathStart[q] = PathEnd[q] = Used;
+				if(Cost[q] == FLT_MAX) continue;
+				if(Used + G->NumVert > Size)
+				{
+					Size = 2 * Size + G->NumVert;
+					PathVert = (int *) realloc(PathVert, Size * sizeof(int));
+				}
+				for(v = Dst[q]; v != Src[q]; v = Pred[v]) PathVert[Used++] = v;
+				PathVert[Used++] = Src[q];
+				PathEnd[q] = Used;
+			}
+		}
+
+		/* Answer in the order asked */
+		for(q = 0; q < Count; q++)
+		{
+			if(Cost[q] == FLT_MAX)
+			{
+				printf("%d %d inf\n", Src[q], Dst[q]);
+				continue;
+			}
+			printf("%d %d %.2f", Src[q], Dst[q], Cost[q]);
+			for(v = PathEnd[q] - 1; v >= PathStart[q]; v--)
+				printf(" %d", PathVert[v]);
+			printf("\n");
+		}
+	}
+	end = WallMs();
+
+	if(In != stdin) fclose(In);
+	Searches += Cache->Misses;
+	OperationItems = Queries;
+	printf("After Batch command on a graph with %d vertices, %d queries took %d searches and %ld cache hits,",
+			NumberOfVertices, Queries, Searches, Cache->Hits);
+	printf("\ntime = %g ms\n\n", end-start);
+	free(Src); free(Dst); free(Order); free(Cost); free(PathStart); free(PathEnd); free(PathVert);
+	tree_cache_destruct(Cache);
+	workspace_destruct(WS);
+}
+
+
+/* Function for comparing the priority queues on the graph.  Each queue runs the
+ * same searches from up to BENCH_SOURCES sources spread over the graph.  The
+ * linear scan takes time in the square of the vertices whatever the edges, so
+ * on sparse graphs it is only run up to BENCH_SCAN_MAX vertices.
+ */
+#define BENCH_SOURCES 64
+#define BENCH_SCAN_MAX 5000
+
+void QueueBenchCommand(graph_t *G)
+{
+	int i, j, k, Sources;
+	double Check, FirstCheck = -1, Ops, Total;
+	long long Inserts, Decreases, Removes;
+	int MaxCount;
+	double start, end;
+	PQStats Stats;
+	SPWorkspace *WS;
+
+	Sources = (G->NumVert < BENCH_SOURCES) ? G->NumVert : BENCH_SOURCES;
+	graph_finalize(G);					//Not part of any queue's time
+	WS = workspace_construct();
+	WS->Threads = Threads;
+
+	printf("%d searches on a graph with %d vertices and %d edges\n\n", Sources, G->NumVert, G->EdgeOffset[G->NumVert]);
+	printf("%-10s %10s %12s %12s %12s %9s %10s\n", "Queue", "Time (ms)", "Inserts", "Decreases", "Removes", "Max size", "Mops/sec");
+
+	for(k = 0; PQFamily[k] != NULL; k++)
+	{
+		Inserts = Decreases = Removes = 0;
+		MaxCount = 0;
+		Check = 0;
+
+		start = WallMs();
+		for(i = 0; i < Sources; i++)
+		{
+			ShortestPathQueueWith(G, PQFamily[k], (int) ((long long) i * G->NumVert / Sources), FALSE, WS, &Stats);
+			Inserts += Stats.Inserts;
+			Decreases += Stats.DecreaseKeys;
+			Removes += Stats.Removes;
+			if(MaxCount < Stats.MaxCount) MaxCount = Stats.MaxCount;
+
+			/* Sum the reachable distances so the queues can be checked against each other */
+			for(j = 0; j < G->NumVert; j++)
+				if(WS->Dist[j] != FLT_MAX) Check += WS->Dist[j];
+		}
+		end = WallMs();
+
+		Total = end-start;
+		Ops = (double) (Inserts + Decreases + Removes);
+		printf("%-10s %10.2f %12lld %12lld %12lld %9d %10.2f\n", PQFamily[k]->Name, Total,
+				Inserts, Decreases, Removes, MaxCount, (Total > 0) ? Ops / (Total * 1000) : 0);
+
+		if(FirstCheck < 0) FirstCheck = Check;
+		else if(fabs(Check - FirstCheck) > 1e-6 * FirstCheck)
+			printf("  %s found different distances than %s!\n", PQFamily[k]->Name, PQFamily[0]->Name);
+	}
+
+	/* The engines without a queue in pqueue.h, for reference */
+	if(!G->IsSparse || G->NumVert <= BENCH_SCAN_MAX)
+	{
+		start = WallMs();
+		for(i = 0; i < Sources; i++)
+			ShortestPathWith(G, SP_SCAN, (int) ((long long) i * G->NumVert / Sources), FALSE, WS);
+		end = WallMs();
+		printf("%-10s %10.2f\n", "scan", end-start);
+	}
+	else
+		printf("%-10s %10s  (sparse graph over %d vertices)\n", "scan", "skipped", BENCH_SCAN_MAX);
+
+	if(graph_weight_scale(G) > 0)
+	{
+		start = WallMs();
+		for(i = 0; i < Sources; i++)
+			ShortestPathWith(G, SP_RADIX, (int) ((long long) i * G->NumVert / Sources), FALSE, WS);
+		end = WallMs();
+		printf("%-10s %10.2f\n", "radix", end-start);
+	}
+
+	graph_delta_width(G);				//Not part of the search time
+	Check = 0;
+	start = WallMs();
+	for(i = 0; i < Sources; i++)
+	{
+		ShortestPathWith(G, SP_DELTA, (int) ((long long) i * G->NumVert / Sources), FALSE, WS);
+		for(j = 0; j < G->NumVert; j++)
+			if(WS->Dist[j] != FLT_MAX) Check += WS->Dist[j];
+	}
+	end = WallMs();
+	printf("%-10s %10.2f\n", "delta", end-start);
+	if(fabs(Check - FirstCheck) > 1e-6 * FirstCheck)
+		printf("  delta found different distances than %s!\n", PQFamily[0]->Name);
+	printf("\n");
+	workspace_destruct(WS);
+}
+
+
+/* Function for the Nearest Vertices Command.  The source itself is confirmed
+ * first, so it is skipped in the list.
+ */
+void NearestCommand(graph_t *G)
+{
+	int i, Count;
+	double start, end;
+	search_t *S;
+	SPWorkspace *WS = workspace_construct();
+
+	start = WallMs();
+	S = search_construct_with(G, NULL, NumberOfSourceVertex, WS);
+	if(Method == 2) Count = search_within(S, Radius);
+	else Count = search_next(S, (KCount > 0 ? KCount : 5) + 1);
+	end = WallMs();
+
+	if(Method == 2)
+		printf("\nThere are %d vertices within distance %g of %d\n", Count - 1, Radius, NumberOfSourceVertex);
+	else
+		printf("\nThe %d nearest vertices to %d\n", Count - 1, NumberOfSourceVertex);
+	for(i = 1; i < Count; i++)
+		printf("%d: %d with cost %.2f\n", i, S->Order[i], S->ShDis[S->Order[i]]);
+
+	printf("After Nearest command on a graph with %d vertices, %d were confirmed,", NumberOfVertices, S->Settled);
+	printf("\ntime = %g ms\n\n", end-start);
+	search_destruct(S);
+	workspace_destruct(WS);
+}
+
+
+/* Compares two run times for qsort */
+int CompareTime(const void *a, const void *b)
+{
+	double x = *(const double *) a, y = *(const double *) b;
+	return (x > y) - (x < y);
+}
+
+/* Function for timing the operation.  It is run BenchWarmups times untimed,
+ * then BenchRuns times on the monotonic clock, and the median and 95th
+ * percentile wall times are printed and, with -B, added to a CSV file.  The
+ * throughput is in the operation's own unit from OperationUnit.
+ * -h 3 removes edges, so the graph is rebuilt, untimed, before each run.
+ */
+void BenchCommand(graph_t **G)
+{
+	int i, Runs, Edges;
+	double start, end, *Time, Median, P95, Rate;
+	FILE *Out;
+
+	Runs = (BenchRuns > 0) ? BenchRuns : 1;
+	Time = (double *) malloc(Runs * sizeof(double));
+	Edges = (*G)->EdgeCount;
+
+	for(i = 0; i < BenchWarmups + Runs; i++)
+	{
+		if(i > 0 && GraphOperation == 3)
+		{
+			graph_destruct(*G);
+			*G = BuildGraph();
+		}
+		start = WallMs();
+		RunOperation(*G);
+		end = WallMs();
+		if(i >= BenchWarmups) Time[i - BenchWarmups] = end - start;
+	}
+
+	/* Nearest-rank percentiles of the sorted times */
+	qsort(Time, Runs, sizeof(double), CompareTime);
+	Median = (Runs % 2) ? Time[Runs / 2] : (Time[Runs / 2 - 1] + Time[Runs / 2]) / 2;
+	P95 = Time[(int) ceil(0.95 * Runs) - 1];
 
+	printf("Benchmark of -h %d -m %d on %d vertices and %d edges: %d runs after %d warm-up runs\n",
+			GraphOperation, Method, NumberOfVertices, Edges, Runs, BenchWarmups);
+	Rate = (Median > 0) ? OperationItems / (Median / 1000) : 0;	//Items of the last run
+	printf("median = %g ms, p95 = %g ms, min = %g ms, max = %g ms, %.3g %s/sec\n\n",
+			Median, P95, Time[0], Time[Runs - 1], Rate, OperationUnit[GraphOperation]);
+
+	if(BenchFile != NULL)
+	{
+		if((Out = fopen(BenchFile, "a")) == NULL)
+		{
+			fprintf(stderr, "cannot open benchmark file: %s\n", BenchFile);
+			exit(1);
+		}
+		if(ftell(Out) == 0)
+			fprintf(Out, "operation,method,engine,graph,vertices,adjacent,edges,threads,warmups,runs,"
+						 "median_ms,p95_ms,min_ms,max_ms,per_sec,unit\n");
+		fprintf(Out, "%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6g,%s\n",
+				GraphOperation, Method, Engine, GraphType, NumberOfVertices, AdjacentVertices, Edges,
+				apsp_thread_count(Threads), BenchWarmups, Runs, Median, P95, Time[0], Time[Runs - 1],
+				Rate, OperationUnit[GraphOperation]);
+		fclose(Out);
+	}
+	free(Time);
 }
 
 
@@ -439,6 +1119,7 @@ void debug_print_graph(graph_t *G)
 void AdjacencyPrint(graph_t *G)
 {
 	int i, j;
+	double Weight;
 
 	/* Printing of adjacency matrix */
 	printf("\nAdjacency Matrix");
@@ -452,10 +1133,11 @@ void AdjacencyPrint(graph_t *G)
 		printf("%d", i);
 		for(j=0; j<G->NumVert; j++){
 			//Print INFIN if the weight is infinite
-			if(G->AdjMatrix[i][j] == FLT_MAX)
+			Weight = graph_edge_weight(G, i, j);
+			if(Weight == FLT_MAX)
 				printf(" %4s", "INF");
 			else
-				printf(" %4.2f", G->AdjMatrix[i][j]);
+				printf(" %4.2f", Weight);
 		}
 		printf("\n");
 	}
@@ -479,7 +1161,7 @@ void getCommandLine(int argc, char **argv)
 	int c;
 	int index;
 
-	while ((c = getopt(argc, argv, "g:n:a:h:s:d:r:vp")) != -1)
+	while ((c = getopt(argc, argv, "g:n:a:h:s:d:r:vpSMFe:t:m:k:w:b:C:o:l:f:R:W:B:J:T:")) != -1)
 		switch(c) {
 			case 'g': 
 				if(1 <= atoi(optarg) && atoi(optarg) <= 4) {
@@ -495,7 +1177,7 @@ void getCommandLine(int argc, char **argv)
 			case 'n': NumberOfVertices = atoi(optarg);			break;
 			case 'a': AdjacentVertices = atoi(optarg);			break;
 			case 'h': 
-				if(1 <= atoi(optarg) && atoi(optarg) <= 3)
+				if(1 <= atoi(optarg) && atoi(optarg) <= 7)
 					GraphOperation = atoi(optarg);
 				else {
 					fprintf(stderr, "invalid graph operation: %s\n", optarg);
@@ -507,6 +1189,31 @@ void getCommandLine(int argc, char **argv)
 			case 'r': Seed = atoi(optarg);						break;
 			case 'v': Verbose = TRUE;							break;
 			case 'p': Printer = TRUE;							break;
+			case 'S': Sparse = TRUE;							break;
+			case 'M': Sparse = FALSE;							break;
+			case 'F': FloatWeights = TRUE;						break;
+			case 't': Threads = atoi(optarg);					break;
+			case 'm': Method = atoi(optarg);					break;
+			case 'k': KCount = atoi(optarg);					break;
+			case 'w': Radius = atof(optarg);					break;
+			case 'b': BatchFile = optarg;						break;
+			case 'C': CacheMB = atoi(optarg);					break;
+			case 'o': SaveFile = optarg;						break;
+			case 'l': LoadFile = optarg;						break;
+			case 'f': ReadFile = optarg;						break;
+			case 'R': BenchRuns = atoi(optarg);					break;
+			case 'W': BenchWarmups = atoi(optarg);				break;
+			case 'B': BenchFile = optarg;						break;
+			case 'J': CountersFile = optarg;					break;
+			case 'T': TraceFile = optarg; Verbose = TRUE;		break;
+			case 'e': 
+				if(SP_AUTO <= atoi(optarg) && atoi(optarg) <= SP_DELTA)
+					Engine = atoi(optarg);
+				else {
+					fprintf(stderr, "invalid shortest path engine: %s\n", optarg);
+					exit(1);
+				}
+				break;
 			case '?':
 				if (isprint(optopt))
 					fprintf(stderr, "Unknown option %c.\n", optopt);
@@ -518,12 +1225,42 @@ void getCommandLine(int argc, char **argv)
 				printf("  -g 1|2|3|4    type of graph (default 1)\n");
 				printf("  -n N          number of vertices in graph\n");
 				printf("  -a 0<R<N      number of vertices in graph\n");
-				printf("  -h 1|2|3      graph operation (default 1)\n");
+				printf("  -h 1-7        graph operation (default 1)\n");
+				printf("                1 shortest path, 2 diameter, 3 link-disjoint paths, 4 queue comparison,\n");
+				printf("                5 nearest vertices, 6 cheapest K link-disjoint paths, 7 batch of queries\n");
 				printf("  -s 0<=S<N     number of the source vertex\n");
 				printf("  -d 0<=D<N     number of the destination vertex\n");
 				printf("  -v            turn on verbose prints (default off)\n");
 				printf("  -p            turn on debug print (default off) (NOT recommended for large graphs\n");
 				printf("  -r 1234567    seed for random number generator\n");
+				printf("  -S            store the graph in compressed sparse row form (default for -g 4)\n");
+				printf("  -M            store the graph as an adjacency matrix (default for -g 1|2|3)\n");
+				printf("  -F            store the matrix weights as 32-bit floats instead of doubles\n");
+				printf("  -e 0-8        shortest path engine (default 0)\n");
+				printf("                0 chosen from graph, 1 linear scan, 2 binary heap, 3 radix heap,\n");
+				printf("                4 4-ary heap, 5 8-ary heap, 6 pairing heap, 7 Fibonacci heap,\n");
+				printf("                8 delta-stepping over -t threads\n");
+				printf("  -t T          threads for all-source commands and -e 8 (default 0, one per core)\n");
+				printf("  -m M          method for the operation (default 1)\n");
+				printf("                -h 1: 1 search from both ends, 2 search from the source, 3 stop at the destination,\n");
+				printf("                      4 A* with the vertex positions\n");
+				printf("                -h 2: 1 search from every vertex, 2 eccentricity bounds, 3 Floyd-Warshall\n");
+				printf("                -h 3: 1 remove each shortest path in turn, 2 maximum flow,\n");
+				printf("                      3 like 1, repairing the search instead of rerunning it\n");
+				printf("                -h 5: 1 the K nearest vertices, 2 the vertices within distance W\n");
+				printf("  -k K          number of nearest vertices for -h 5 -m 1 (default 5),\n");
+				printf("                or of paths for -h 6 (default 2)\n");
+				printf("  -w W          distance for -h 5 -m 2 (default 1)\n");
+				printf("  -b FILE       file of \"S D\" lines for -h 7, - for stdin (default -)\n");
+				printf("  -C MB         memory for searches kept between chunks of -h 7 (default 64)\n");
+				printf("  -o FILE       save the graph to a snapshot file after building it\n");
+				printf("  -l FILE       load the graph from a snapshot file instead of building one\n");
+				printf("  -f FILE       read the graph from a DIMACS .gr file or an edge list of \"U V [W]\" lines\n");
+				printf("  -R N          time N runs of the operation, printing the median and 95th percentile\n");
+				printf("  -W N          untimed warm-up runs before the timed ones (default 0)\n");
+				printf("  -B FILE       add the timings to a CSV file\n");
+				printf("  -J FILE       add the work counters to FILE as JSON lines (make COUNTERS=1 builds only)\n");
+				printf("  -T FILE       write every search step to a trace file for ./tracedump (implies -v)\n");
 				exit(1);
 		}
 	for (index = optind; index < argc; index++)
@@ -532,12 +1269,82 @@ void getCommandLine(int argc, char **argv)
 
 
 	/* Make sure all values are viable */
-	if(!(0 < AdjacentVertices && AdjacentVertices < NumberOfVertices))
+	if(LoadFile == NULL && ReadFile == NULL && !(0 < AdjacentVertices && AdjacentVertices < NumberOfVertices))
 	{
 		fprintf(stderr, "invalid number of adjacent vertices : %d\n", AdjacentVertices);
 		exit(1);
 	}
 
+	if(GraphOperation == 1 && !(0 <= Method && Method <= PATH_ASTAR))
+	{
+		fprintf(stderr, "invalid shortest path method: %d\n", Method);
+		exit(1);
+	}
+
+	if(GraphOperation == 3 && !(0 <= Method && Method <= LINK_REPAIR))
+	{
+		fprintf(stderr, "invalid link-disjoint paths method: %d\n", Method);
+		exit(1);
+	}
+
+	if(GraphOperation == 5 && !(0 <= Method && Method <= 2))
+	{
+		fprintf(stderr, "invalid nearest vertices method: %d\n", Method);
+		exit(1);
+	}
+
+#ifndef COUNTERS
+	if(CountersFile != NULL)
+	{
+		fprintf(stderr, "-J needs a build with make COUNTERS=1\n");
+		exit(1);
+	}
+#endif
+
+	if(BenchRuns < 0 || BenchWarmups < 0)
+	{
+		fprintf(stderr, "invalid number of runs: %d, %d\n", BenchRuns, BenchWarmups);
+		exit(1);
+	}
+
+	/* Standard input can only be read by the first run */
+	if(GraphOperation == 7 && strcmp(BatchFile, "-") == 0 && BenchWarmups + (BenchRuns > 0 ? BenchRuns : 1) > 1)
+	{
+		fprintf(stderr, "-R and -W need the queries in a file given with -b\n");
+		exit(1);
+	}
+
+	if(CacheMB < 0)
+	{
+		fprintf(stderr, "invalid cache size: %d\n", CacheMB);
+		exit(1);
+	}
+
+	if(KCount < 0 || Radius < 0)
+	{
+		fprintf(stderr, "invalid count or distance: %d, %g\n", KCount, Radius);
+		exit(1);
+	}
+
+	if(GraphOperation == 2 && !(0 <= Method && Method <= DIAM_FLOYD))
+	{
+		fprintf(stderr, "invalid diameter method: %d\n", Method);
+		exit(1);
+	}
+
+	if(Threads < 0)
+	{
+		fprintf(stderr, "invalid number of threads: %d\n", Threads);
+		exit(1);
+	}
+
+	//The size of a loaded or read graph isn't known yet
+	if(LoadFile == NULL && ReadFile == NULL) CheckEndpoints();
+}
+
+/* Makes sure the source and destination are vertices of the graph */
+void CheckEndpoints(void)
+{
 	if(!(0 <= NumberOfSourceVertex && NumberOfSourceVertex < NumberOfVertices))
 	{
 		fprintf(stderr, "invalid number of source vertex: %d\n", NumberOfSourceVertex);
@@ -549,6 +1356,5 @@ void getCommandLine(int argc, char **argv)
 		fprintf(stderr, "invalid number of destination vertex: %d\n", NumberOfSourceVertex);
 		exit(1);
 	}
-
 }
 
@@ -0,0 +1,171 @@
+/* pairing.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * A pairing heap.  Each vertex has one node, stored in an array indexed by the
+ * vertex, holding its first child and its next sibling.  Lowering a key cuts
+ * the node's subtree off and melds it with the root.  Removing the root melds
+ * its children in pairs from left to right and then melds the pairs from right
+ * to left.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include "heap.h"
+#include "pqueue.h"
+#include "counters.h"
+
+typedef  struct {
+    double   weight;
+    int      Child;                /* first child, -1 if none */
+    int      Sibling;              /* next sibling, -1 if none */
+    int      Prev;                 /* previous sibling, or parent if first child */
+    int      InHeap;
+} PairNode;
+
+typedef  struct {
+    int      Root;
+    int      Count;
+    int      MaxCount;
+    int      NumVertices;
+    PairNode *Node;
+    int      *Pairs;               /* scratch list for removing the root */
+} PairingHeap;
+
+/*--------------------------------------------------*/
+
+/* Makes the root with the larger key the first child of the other root */
+static int PairMeld(PairingHeap *H, int a, int b)
+{
+    int t;
+    PairNode *N = H->Node;
+
+    if (N[b].weight < N[a].weight) {
+        t = a; a = b; b = t;
+    }
+    N[b].Sibling = N[a].Child;
+    if (N[a].Child >= 0) N[N[a].Child].Prev = b;
+    N[b].Prev = a;
+    N[a].Child = b;
+    return a;
+}
+
+/*--------------------------------------------------*/
+
+static void *PairInitialize(int num_vertices)
+{
+    int i;
+    PairingHeap *H;
+    H = (PairingHeap *) malloc(sizeof(PairingHeap));
+    H->Root = -1;
+    H->Count = 0;
+    H->MaxCount = 0;
+    H->NumVertices = num_vertices;
+    H->Node = (PairNode *) malloc(num_vertices * sizeof(PairNode));
+    H->Pairs = (int *) malloc(num_vertices * sizeof(int));
+    for (i = 0; i < num_vertices; i++) H->Node[i].InHeap = 0;
+    COUNT(BytesAllocated, sizeof(PairingHeap) + num_vertices * (sizeof(PairNode) + sizeof(int)));
+    return H;
+}
+static void PairDestruct(void *Q)
+{
+    PairingHeap *H = (PairingHeap *) Q;
+    COUNT_PEAK(H->MaxCount);
+    free(H->Node);
+    free(H->Pairs);
+    free(H);
+}
+
+/*--------------------------------------------------*/
+static int PairEmpty(void *Q)
+{
+    return (((PairingHeap *) Q)->Count == 0);
+}
+
+/*--------------------------------------------------*/
+
+static void PairInsert(PQItem Item, void *Q)
+{
+    PairingHeap *H = (PairingHeap *) Q;
+    PairNode *N = H->Node, *x;
+
+    assert(Item.node >= 0 && Item.node < H->NumVertices);
+    x = &N[Item.node];
+
+    if (x->InHeap) {
+        /* Lower the key, and cut the subtree loose unless it's the root */
+        COUNT(DecreaseKeys, 1);
+        x->weight = Item.weight;
+        if (Item.node == H->Root) return;
+        if (N[x->Prev].Child == Item.node) N[x->Prev].Child = x->Sibling;
+        else N[x->Prev].Sibling = x->Sibling;
+        if (x->Sibling >= 0) N[x->Sibling].Prev = x->Prev;
+    }
+    else {
+        COUNT(Inserts, 1);
+        x->weight = Item.weight;
+        x->Child = -1;
+        x->InHeap = 1;
+        (H->Count)++;
+        if (H->Count > H->MaxCount) H->MaxCount = H->Count;
+    }
+    x->Sibling = -1;
+    x->Prev = -1;
+
+    if (H->Root < 0) H->Root = Item.node;
+    else H->Root = PairMeld(H, H->Root, Item.node);
+}
+
+/*--------------------------------------------------*/
+
+static PQItem PairRemove(void *Q)
+{
+    PairingHeap *H = (PairingHeap *) Q;
+    PairNode *N = H->Node;
+    int a, b, c, Next, n = 0;
+    PQItem ItemToReturn;
+
+    if (PairEmpty(Q))        /* result is undefined if the heap was empty */
+    {
+        printf("Attempting to remove from empty pairing heap\n");
+        exit(1);
+    }
+
+    COUNT(Removes, 1);
+    ItemToReturn.node = H->Root;
+    ItemToReturn.weight = N[H->Root].weight;
+    N[H->Root].InHeap = 0;
+    (H->Count)--;
+
+    /* First pass: meld the children two at a time, left to right */
+    for (c = N[H->Root].Child; c >= 0; c = Next) {
+        a = c;
+        b = N[a].Sibling;
+        Next = (b >= 0) ? N[b].Sibling : -1;
+        N[a].Sibling = N[a].Prev = -1;
+        if (b >= 0) {
+            N[b].Sibling = N[b].Prev = -1;
+            a = PairMeld(H, a, b);
+        }
+        H->Pairs[n++] = a;
+    }
+
+    /* Second pass: meld the pairs into one tree, right to left */
+    H->Root = -1;
+    if (n > 0) {
+        H->Root = H->Pairs[n-1];
+        for (n = n - 2; n >= 0; n--)
+            H->Root = PairMeld(H, H->Pairs[n], H->Root);
+    }
+
+    return ItemToReturn;
+}
+
+/*--------------------------------------------------*/
+
+const PQOps PQPairing = {
+    "pairing", PairInitialize, PairDestruct, PairEmpty, PairInsert, PairRemove
+};
@@ -0,0 +1,46 @@
+/* pqueue.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * Hooks the binary heap from heap2.c into the common queue interface and
+ * lists every queue so they can be compared.
+ */
+
+#include <stdlib.h>
+#include "heap.h"
+#include "pqueue.h"
+
+/*--------------------------------------------------*/
+
+static void *BinaryInitialize(int NumVertices)
+{
+    return PQInitialize(NumVertices);
+}
+static void BinaryDestruct(void *Q)
+{
+    PQDestruct((PriorityQueue *) Q);
+}
+static int BinaryEmpty(void *Q)
+{
+    return PQEmpty((PriorityQueue *) Q);
+}
+static void BinaryInsert(PQItem Item, void *Q)
+{
+    PQInsert(Item, (PriorityQueue *) Q);
+}
+static PQItem BinaryRemove(void *Q)
+{
+    return PQRemove((PriorityQueue *) Q);
+}
+
+const PQOps PQBinary = {
+    "binary", BinaryInitialize, BinaryDestruct, BinaryEmpty, BinaryInsert, BinaryRemove
+};
+
+/*--------------------------------------------------*/
+
+const PQOps *PQFamily[] = {
+    &PQBinary, &PQDHeap4, &PQDHeap8, &PQPairing, &PQFibonacci, NULL
+};
@@ -0,0 +1,36 @@
+/* pqueue.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * A common interface for the priority queues used by Dijkstra's algorithm.
+ * Every queue holds each vertex at most once; inserting a vertex that is
+ * already queued lowers its key instead of adding a duplicate.  Include
+ * heap.h before this file for PQItem.
+ */
+
+typedef struct PQOps {
+    const char *Name;
+    void   *(*Initialize)(int NumVertices);     /* empty queue for vertices 0..N-1 */
+    void   (*Destruct)(void *Q);
+    int    (*Empty)(void *Q);                   /* true if Q is empty */
+    void   (*Insert)(PQItem Item, void *Q);     /* insert, or lower the key of, Item */
+    PQItem (*Remove)(void *Q);                  /* removes the smallest Item */
+} PQOps;
+
+/* Work done by one search, filled in by ShortestPathQueue */
+typedef struct PQStats {
+    long long Inserts;
+    long long DecreaseKeys;
+    long long Removes;
+    int       MaxCount;
+} PQStats;
+
+extern const PQOps PQBinary;         /* heap2.c */
+extern const PQOps PQDHeap4;         /* dheap.c with 4 children per node */
+extern const PQOps PQDHeap8;         /* dheap.c with 8 children per node */
+extern const PQOps PQPairing;        /* pairing.c */
+extern const PQOps PQFibonacci;      /* fibheap.c */
+
+extern const PQOps *PQFamily[];      /* all of the above, ending in NULL */
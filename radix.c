@@ -0,0 +1,180 @@
+/* radix.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * A radix heap.  An item goes in the bucket numbered by the highest bit in
+ * which its key differs from the last key removed, so bucket 0 holds keys equal
+ * to it and bucket b holds keys that agree with it above bit b-1.  Removing
+ * from an empty bucket 0 finds the smallest key in the first non-empty bucket
+ * and spreads that bucket into the lower ones.  Each item can only move down,
+ * so no comparisons between pairs of items are needed.
+ *
+ * Like heap2.c, the queue keeps the location of each vertex so inserting a
+ * vertex that is already queued moves it to the bucket for its new key rather
+ * than adding a duplicate.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include "radix.h"
+#include "counters.h"
+
+/*--------------------------------------------------*/
+
+/* Bucket for Key relative to the last key removed */
+static int RQBucket(unsigned long long Key, unsigned long long Last)
+{
+    if (Key == Last) return 0;
+    return 64 - __builtin_clzll(Key ^ Last);
+}
+
+/* Adds Item to bucket b, doubling the bucket if it is full */
+static void RQPlace(RQItem Item, int b, RadixQueue *RQ)
+{
+    if (RQ->BucketCount[b] == RQ->BucketSize[b])
+    {
+        RQ->BucketSize[b] = RQ->BucketSize[b] ? 2 * RQ->BucketSize[b] : 16;
+        RQ->Bucket[b] = (RQItem *) realloc(RQ->Bucket[b], RQ->BucketSize[b] * sizeof(RQItem));
+        if (RQ->Bucket[b] == NULL)
+        {
+            printf("Failed to double radix heap bucket!\n");
+            exit(1);
+        }
+        COUNT(BytesAllocated, (RQ->BucketSize[b] - RQ->BucketCount[b]) * sizeof(RQItem));
+    }
+    RQ->ItemBucket[Item.node] = b;
+    RQ->ItemIndex[Item.node] = RQ->BucketCount[b];
+    RQ->Bucket[b][RQ->BucketCount[b]++] = Item;
+}
+
+/* Takes the item at position i out of bucket b by moving the last item of
+ * the bucket into its place
+ */
+static RQItem RQTake(int b, int i, RadixQueue *RQ)
+{
+    RQItem Item = RQ->Bucket[b][i];
+    RQItem Moved = RQ->Bucket[b][--RQ->BucketCount[b]];
+
+    RQ->Bucket[b][i] = Moved;
+    RQ->ItemIndex[Moved.node] = i;
+    RQ->ItemBucket[Item.node] = -1;
+    return Item;
+}
+
+/*--------------------------------------------------*/
+
+RadixQueue *RQInitialize(int num_vertices)
+{
+    int b;
+    RadixQueue *RQ;
+    RQ = (RadixQueue *) malloc(sizeof(RadixQueue));
+    RQ->NumVertices = num_vertices;
+    RQ->ItemBucket = (int *) malloc(num_vertices * sizeof(int));
+    RQ->ItemIndex = (int *) malloc(num_vertices * sizeof(int));
+    for (b = 0; b < num_vertices; b++) RQ->ItemBucket[b] = -1;
+    RQ->Count = 0;
+    RQ->MaxCount = 0;
+    RQ->Last = 0;
+    for (b = 0; b < RQ_BUCKETS; b++) {
+        RQ->BucketSize[b] = 0;
+        RQ->BucketCount[b] = 0;
+        RQ->Bucket[b] = NULL;
+    }
+    COUNT(BytesAllocated, sizeof(RadixQueue) + num_vertices * 2 * sizeof(int));
+    return RQ;
+}
+void RQDestruct(RadixQueue *RQ)
+{
+    int b;
+    COUNT_PEAK(RQ->MaxCount);
+    for (b = 0; b < RQ_BUCKETS; b++) free(RQ->Bucket[b]);
+    free(RQ->ItemBucket);
+    free(RQ->ItemIndex);
+    free(RQ);
+}
+
+/*--------------------------------------------------*/
+
+/* Takes every item out and lets keys start again from 0, so one queue can be
+ * used for search after search */
+void RQReset(RadixQueue *RQ)
+{
+    int b, i;
+    for (b = 0; b < RQ_BUCKETS; b++) {
+        for (i = 0; i < RQ->BucketCount[b]; i++)
+            RQ->ItemBucket[RQ->Bucket[b][i].node] = -1;
+        RQ->BucketCount[b] = 0;
+    }
+    RQ->Count = 0;
+    RQ->Last = 0;
+}
+
+/*--------------------------------------------------*/
+int RQEmpty(RadixQueue *RQ)
+{
+    return (RQ->Count == 0);
+}
+
+/*--------------------------------------------------*/
+
+void RQInsert(RQItem Item, RadixQueue *RQ)
+{
+    assert(Item.node >= 0 && Item.node < RQ->NumVertices);
+
+    if (Item.key < RQ->Last) {
+        printf("Radix heap key %llu is below the last key removed!\n", Item.key);
+        exit(1);
+    }
+
+    // If the Item is already queued then take out the old entry first
+    if (RQ->ItemBucket[Item.node] >= 0) {
+        COUNT(DecreaseKeys, 1);
+        RQTake(RQ->ItemBucket[Item.node], RQ->ItemIndex[Item.node], RQ);
+    }
+    else {
+        COUNT(Inserts, 1);
+        (RQ->Count)++;
+        if (RQ->Count > RQ->MaxCount) RQ->MaxCount = RQ->Count;
+    }
+    RQPlace(Item, RQBucket(Item.key, RQ->Last), RQ);
+}
+
+/*--------------------------------------------------*/
+
+RQItem RQRemove(RadixQueue *RQ)
+{
+    int b, i, n;
+    unsigned long long MinKey;
+    RQItem *Items;
+
+    if (RQEmpty(RQ))        /* result is undefined if RQ was empty */
+    {
+        printf("Attempting to remove from empty radix heap\n");
+        exit(1);
+    }
+    COUNT(Removes, 1);
+
+    if (RQ->BucketCount[0] == 0)
+    {
+        /* Find the first bucket with items and its smallest key */
+        for (b = 1; RQ->BucketCount[b] == 0; b++)
+            ;
+        Items = RQ->Bucket[b];
+        n = RQ->BucketCount[b];
+        MinKey = Items[0].key;
+        for (i = 1; i < n; i++)
+            if (Items[i].key < MinKey) MinKey = Items[i].key;
+
+        /* Every item in bucket b lands in a lower bucket under the new Last */
+        RQ->Last = MinKey;
+        RQ->BucketCount[b] = 0;
+        for (i = 0; i < n; i++)
+            RQPlace(Items[i], RQBucket(Items[i].key, MinKey), RQ);
+    }
+
+    (RQ->Count)--;
+    return RQTake(0, RQ->BucketCount[0] - 1, RQ);
+}
@@ -0,0 +1,37 @@
+/* radix.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * A monotone priority queue for integer keys (a radix heap).  The interface
+ * follows heap.h, but the keys must be whole numbers and no key may be smaller
+ * than the last key removed, which always holds for Dijkstra's algorithm.
+ */
+
+#define RQ_BUCKETS 65       // one bucket per bit of the key, plus one
+
+typedef  struct {
+    int node;
+    unsigned long long key;
+} RQItem;
+
+typedef  struct {
+    int      Count;
+    int      MaxCount;
+    unsigned long long Last;                 /* last key removed */
+    int      BucketSize[RQ_BUCKETS];
+    int      BucketCount[RQ_BUCKETS];
+    RQItem   *Bucket[RQ_BUCKETS];
+    int      NumVertices;
+    int      *ItemBucket;      /* bucket holding each vertex, -1 if none */
+    int      *ItemIndex;       /* position of each vertex in its bucket */
+} RadixQueue;
+
+
+extern RadixQueue *RQInitialize(int);             /* sets RQ to be empty */
+void RQDestruct(RadixQueue *RQ);
+void RQReset(RadixQueue *RQ);                     /* empties RQ for a new search */
+extern int RQEmpty(RadixQueue *RQ);               /* true if RQ is empty */
+extern void RQInsert(RQItem Item, RadixQueue *RQ);  /* puts Item into RQ */
+extern RQItem RQRemove(RadixQueue *RQ);          /* removes Item from RQ */
@@ -0,0 +1,509 @@
+/* reader.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * This file reads graph files straight into compressed sparse row form.  The
+ * file is split into one byte range per thread, and each thread reads its
+ * range with pread, READ_CHUNK bytes at a time.  A thread owns the lines that
+ * start inside its range, so it skips the partial line at its start and
+ * finishes the line that crosses its end.
+ *
+ * The file is read twice.  The first pass only counts the out-edges of each
+ * vertex in each range; those counts give every thread the place in the CSR
+ * arrays of each of its edges, so the second pass stores the edges there, in
+ * file order, holding no more than READ_BATCH of them at a time.  Reading
+ * needs the CSR arrays, one int per vertex for each thread, and READ_CHUNK
+ * bytes plus READ_BATCH edges for each thread.  There are only as many
+ * threads as keep their counts within a READ_SHARE of the edge arrays: the
+ * sizes are guessed before the counting pass, from the "p" line or the ends
+ * of the file, and neighbouring ranges are merged after it if the guess was
+ * too low.
+ * graph_finalize then drops self loops and keeps the last weight given to a
+ * repeated edge in place, as if the edges had been added one by one.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <float.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+#include "reader.h"
+
+/* One thread's byte range of the file, and its count of the out-edges of
+ * each vertex in it.  Once they're counted, Cursor[u] is where the next edge
+ * of u from this range goes. */
+typedef  struct {
+	const char	*Path;
+	int			File;
+	int			Dimacs;
+	off_t		Begin;
+	off_t		End;
+	int			Storing;		//FALSE on the counting pass
+	graph_t		*G;				//The graph being filled on the second pass
+	int			Count;			//Edges found in the range
+	int			Size;			//Vertices Cursor has room for
+	int			*Cursor;
+	int			MaxVert;		//Largest vertex number seen, -1 if none
+	int			NumVert;		//From a "p" line, -1 if none was in the range
+	int			Held;			//Edges parsed but not yet stored
+	int			*HeldSource;
+	int			*HeldDest;
+	double		*HeldWeight;
+	pthread_t	Thread;
+} ReadWorker;
+
+
+/* Reports a line that can't be read and stops */
+static void BadLine(ReadWorker *W, const char *Line)
+{
+	fprintf(stderr, "bad line in %s: %s\n", W->Path, Line);
+	exit(1);
+}
+
+/* Gives the counts of W room for exactly Size vertices, with any new counts at 0 */
+static void SizeCursor(ReadWorker *W, int Size)
+{
+	W->Cursor = (int *) realloc(W->Cursor, (size_t) (Size > 0 ? Size : 1) * sizeof(int));
+	if(W->Cursor == NULL)
+	{
+		printf("Failed to grow the edge counts of %s!\n", W->Path);
+		exit(1);
+	}
+	if(Size > W->Size) memset(W->Cursor + W->Size, 0, (size_t) (Size - W->Size) * sizeof(int));
+	W->Size = Size;
+}
+
+/* Makes room in the counts of W for vertex u, for files whose vertex count
+ * was guessed too low */
+static void GrowCursor(ReadWorker *W, int u)
+{
+	int Size = W->Size;
+
+	if(u < Size) return;
+	while(u >= Size) Size = (Size == 0) ? 1024 : 2 * Size;
+	if(Size < 0 || Size > INT_MAX / 2) Size = INT_MAX / 2;
+	SizeCursor(W, Size);
+}
+
+/* Stores the held edges of W at their places in the CSR arrays.  Doing a
+ * batch at a time keeps the scattered stores apart from the parsing, so the
+ * cache misses they take can overlap */
+static void StoreHeld(ReadWorker *W)
+{
+	int i, u, e;
+
+	for(i=0; i<W->Held; i++)
+	{
+		u = W->HeldSource[i];
+		if(u >= W->G->NumVert || W->Cursor[u] >= W->G->EdgeOffset[u + 1])
+		{
+			fprintf(stderr, "%s changed while it was being read\n", W->Path);
+			exit(1);
+		}
+		e = W->Cursor[u]++;
+		W->G->EdgeTarget[e] = W->HeldDest[i];
+		W->G->EdgeWeight[e] = W->HeldWeight[i];
+	}
+	W->Held = 0;
+}
+
+/* Counts the edge from LSource to LDest on the first pass, and stores it on
+ * the second */
+static void AddRead(ReadWorker *W, int LSource, int LDest, double LWeight)
+{
+	if(W->Storing)
+	{
+		W->HeldSource[W->Held] = LSource;
+		W->HeldDest[W->Held] = LDest;
+		W->HeldWeight[W->Held] = LWeight;
+		if(++W->Held == READ_BATCH) StoreHeld(W);
+	}
+	else
+	{
+		GrowCursor(W, LSource);
+		W->Cursor[LSource]++;
+		if(W->Count == INT_MAX)
+		{
+			fprintf(stderr, "too many edges in %s\n", W->Path);
+			exit(1);
+		}
+		if(LSource > W->MaxVert) W->MaxVert = LSource;
+		if(LDest > W->MaxVert) W->MaxVert = LDest;
+	}
+	W->Count++;
+}
+
+/* Reads one line, ended by a '\0' in place of its newline */
+static void ParseLine(ReadWorker *W, char *Line)
+{
+	char *p = Line, *q;
+	long u, v;
+	double w;
+	int n;
+
+	while(isspace((unsigned char) *p)) p++;
+	if(*p == '\0') return;
+	if(W->Dimacs)
+	{
+		if(*p == 'c') return;
+		if(*p == 'p')
+		{
+			if(sscanf(p, "p %*s %d", &n) != 1 || n < 0) BadLine(W, Line);
+			W->NumVert = n;
+			return;
+		}
+		if(*p != 'a') BadLine(W, Line);
+		p++;
+	}
+	else if(*p == '#' || *p == '%') return;
+
+	u = strtol(p, &q, 10);
+	if(q == p) BadLine(W, Line);
+	p = q;
+	v = strtol(p, &q, 10);
+	if(q == p) BadLine(W, Line);
+	p = q;
+	if(W->Dimacs) { u--; v--; }
+	if(u < 0 || v < 0 || u >= INT_MAX || v >= INT_MAX) BadLine(W, Line);
+
+	/* Counting only needs the ends; the second pass checks the rest */
+	if(!W->Storing)
+	{
+		AddRead(W, (int) u, (int) v, 0);
+		return;
+	}
+	w = strtod(p, &q);
+	if(q == p)
+	{
+		if(W->Dimacs) BadLine(W, Line);			//Arcs always have a weight
+		w = 1;
+	}
+	p = q;
+	while(isspace((unsigned char) *p)) p++;
+	if(*p != '\0') BadLine(W, Line);
+
+	if(!(0 <= w && w < FLT_MAX)) BadLine(W, Line);
+	AddRead(W, (int) u, (int) v, w);
+}
+
+/* Reads the lines that start in the byte range of the ReadWorker Arg */
+static void* ReadRange(void *Arg)
+{
+	ReadWorker *W = (ReadWorker *) Arg;
+	char *Buf, *nl, c;
+	off_t Off;
+	ssize_t Got;
+	size_t Have, Len, p;
+	int Skip, Eof;
+
+	Buf = (char *) malloc(READ_CHUNK + 1);
+	if(W->Storing)
+	{
+		W->Held = 0;
+		W->HeldSource = (int *) malloc(READ_BATCH * sizeof(int));
+		W->HeldDest = (int *) malloc(READ_BATCH * sizeof(int));
+		W->HeldWeight = (double *) malloc(READ_BATCH * sizeof(double));
+	}
+	Have = 0;
+	Off = W->Begin;
+
+	/* A range starting in the middle of a line leaves it to the range before */
+	Skip = FALSE;
+	if(W->Begin > 0 && (pread(W->File, &c, 1, W->Begin - 1) != 1 || c != '\n')) Skip = TRUE;
+
+	for(;;)
+	{
+		Got = pread(W->File, Buf + Have, READ_CHUNK - Have, Off + Have);
+		if(Got < 0)
+		{
+			fprintf(stderr, "failed to read %s\n", W->Path);
+			exit(1);
+		}
+		Len = Have + Got;
+		Buf[Len] = '\0';
+		Eof = (Got == 0);
+
+		/* Parse each whole line, stopping at the first one past the range */
+		p = 0;
+		while(p < Len && Off + (off_t) p < W->End)
+		{
+			nl = memchr(Buf + p, '\n', Len - p);
+			if(nl == NULL)
+			{
+				if(!Eof) break;					//Wait for the rest of the line
+				nl = Buf + Len;					//The last line has no newline
+			}
+			*nl = '\0';
+			if(!Skip) ParseLine(W, Buf + p);
+			Skip = FALSE;
+			p = nl - Buf + 1;
+		}
+		if(Eof || Off + (off_t) p >= W->End) break;
+
+		/* Keep the partial line at the end for the next read */
+		Have = Len - p;
+		if(Have == READ_CHUNK)
+		{
+			fprintf(stderr, "line longer than %d bytes in %s\n", READ_CHUNK, W->Path);
+			exit(1);
+		}
+		memmove(Buf, Buf + p, Have);
+		Off += p;
+	}
+
+	if(W->Storing)
+	{
+		StoreHeld(W);
+		free(W->HeldSource); free(W->HeldDest); free(W->HeldWeight);
+	}
+	free(Buf);
+	return NULL;
+}
+
+/* Reads every range, the last one on the calling thread */
+static void ReadAll(ReadWorker *Workers, int Threads)
+{
+	int t;
+
+	for(t = 0; t < Threads - 1; t++)
+	{
+		if(pthread_create(&Workers[t].Thread, NULL, ReadRange, &Workers[t]) != 0)
+		{
+			fprintf(stderr, "Failed to start thread %d\n", t);
+			exit(1);
+		}
+	}
+	ReadRange(&Workers[Threads - 1]);
+	for(t = 0; t < Threads - 1; t++)
+		pthread_join(Workers[t].Thread, NULL);
+}
+
+/* Guesses the edges and vertices in a file of Bytes bytes whose first bytes
+ * are Head, from its "p" line or else from the lines at its start and end,
+ * so the thread count can be picked before anything is counted.  Either guess
+ * is 0 if there is nothing to go on. */
+static void GuessSize(int File, off_t Bytes, int Dimacs, const char *Head, long *Edges, long *Verts)
+{
+	char Tail[4096], *q, *r;
+	const char *p, *Sample[2];
+	long u, v, N, M, Lines = 0, Used = 0, Max = -1;
+	ssize_t Got;
+	int s;
+
+	*Edges = 0;
+	*Verts = 0;
+	for(p = Head; Dimacs && p != NULL; p = strchr(p, '\n'))
+	{
+		while(isspace((unsigned char) *p)) p++;
+		if(*p == 'p' && sscanf(p, "p %*s %ld %ld", &N, &M) == 2)
+		{
+			*Edges = M;
+			*Verts = N;
+			return;
+		}
+	}
+
+	/* Otherwise average the whole lines of both ends; the tail starts with
+	 * part of a line, which is skipped */
+	Sample[0] = Head;
+	Sample[1] = NULL;
+	if(Bytes > (off_t) sizeof(Tail) - 1)
+	{
+		Got = pread(File, Tail, sizeof(Tail) - 1, Bytes - (off_t) (sizeof(Tail) - 1));
+		Tail[Got > 0 ? Got : 0] = '\0';
+		Sample[1] = strchr(Tail, '\n');
+	}
+	for(s = 0; s < 2; s++)
+	{
+		for(p = Sample[s]; p != NULL && (q = strchr(p, '\n')) != NULL; p = q + 1)
+		{
+			Used += q - p + 1;
+			while(p < q && isspace((unsigned char) *p)) p++;
+			if(Dimacs && *p != 'a') continue;
+			if(Dimacs) p++;
+			u = strtol(p, &r, 10);
+			if(r == p || r > q) continue;
+			v = strtol(r, (char **) &p, 10);
+			if(p == r || p > q) continue;
+			Lines++;
+			if(u > Max) Max = u;
+			if(v > Max) Max = v;
+		}
+	}
+	if(Lines == 0) return;
+	*Edges = (long) ((double) Bytes * Lines / Used);
+	*Verts = Dimacs ? Max : Max + 1;
+}
+
+/* The most threads whose vertex counts together take no more than a
+ * READ_SHARE of the edge arrays, and at least one */
+static int CountThreads(long Edges, long Verts)
+{
+	double Most;
+
+	if(Verts <= 0) return INT_MAX;
+	Most = (double) Edges * (sizeof(int) + sizeof(double)) / ((double) READ_SHARE * Verts * sizeof(int));
+	if(Most < 1) return 1;
+	return (Most > INT_MAX) ? INT_MAX : (int) Most;
+}
+
+/* Reads the graph in the file Path with up to Threads threads.  The graph is
+ * sparse and has no vertex positions.
+ */
+graph_t* graph_read(const char *Path, int Threads)
+{
+	int t, g, u, e, c, n, Dimacs, First, Last;
+	int *Counted;
+	long Total, Edges, Verts;
+	char Head[4096];
+	ssize_t Got;
+	struct stat Info;
+	ReadWorker *Workers, *W;
+	graph_t *G;
+
+	Workers = (ReadWorker *) malloc((Threads > 0 ? Threads : 1) * sizeof(ReadWorker));
+	Counted = (int *) malloc((Threads > 0 ? Threads : 1) * sizeof(int));
+	Workers[0].File = open(Path, O_RDONLY);
+	if(Workers[0].File < 0 || fstat(Workers[0].File, &Info) != 0)
+	{
+		fprintf(stderr, "cannot open graph file: %s\n", Path);
+		exit(1);
+	}
+
+	/* The first word tells the formats apart */
+	Got = pread(Workers[0].File, Head, sizeof(Head) - 1, 0);
+	Head[Got > 0 ? Got : 0] = '\0';
+	for(t=0; isspace((unsigned char) Head[t]); t++)
+		;
+	Dimacs = (Head[t] != '\0' && strchr("cpa", Head[t]) != NULL);
+
+	/* Give each thread at least one chunk, and keep the vertex counts of all
+	 * the threads well below the size of the edges */
+	GuessSize(Workers[0].File, Info.st_size, Dimacs, Head, &Edges, &Verts);
+	if(Threads > Info.st_size / READ_CHUNK) Threads = Info.st_size / READ_CHUNK;
+	if(Threads > CountThreads(Edges, Verts)) Threads = CountThreads(Edges, Verts);
+	if(Threads < 1) Threads = 1;
+
+	for(t=0; t<Threads; t++)
+	{
+		W = &Workers[t];
+		W->Path = Path;
+		W->File = Workers[0].File;
+		W->Dimacs = Dimacs;
+		W->Begin = Info.st_size / Threads * t;
+		W->End = (t == Threads - 1) ? Info.st_size : Info.st_size / Threads * (t + 1);
+		W->Storing = FALSE;
+		W->G = NULL;
+		W->Count = 0;
+		W->Size = 0;
+		W->Cursor = NULL;
+		W->MaxVert = -1;
+		W->NumVert = -1;
+		if(Verts > 0 && Verts <= INT_MAX / 2) SizeCursor(W, (int) Verts);
+	}
+
+	ReadAll(Workers, Threads);
+
+	/* The vertex count comes from the "p" line, or from the largest vertex */
+	n = 0;
+	Total = 0;
+	for(t=0; t<Threads; t++)
+	{
+		if(Dimacs && Workers[t].NumVert >= 0) n = Workers[t].NumVert;
+		if(!Dimacs && Workers[t].MaxVert >= n) n = Workers[t].MaxVert + 1;
+		Total += Workers[t].Count;
+	}
+	if(Total >= INT_MAX)
+	{
+		fprintf(stderr, "too many edges in %s\n", Path);
+		exit(1);
+	}
+	for(t=0; t<Threads; t++)
+	{
+		if(Workers[t].MaxVert >= n)
+		{
+			fprintf(stderr, "vertex %d in %s is not below the count of %d\n", Workers[t].MaxVert + Dimacs, Path, n);
+			exit(1);
+		}
+		SizeCursor(&Workers[t], n);
+	}
+
+	/* If the guess was off, merge neighbouring ranges, adding up their counts,
+	 * until the counts are back within their share */
+	g = CountThreads(Total, n);
+	if(Threads > g)
+	{
+		for(c=0; c<g; c++)
+		{
+			First = (int) ((long) Threads * c / g);
+			Last = (int) ((long) Threads * (c + 1) / g);
+			Workers[c] = Workers[First];
+			for(t=First+1; t<Last; t++)
+			{
+				for(u=0; u<n; u++) Workers[c].Cursor[u] += Workers[t].Cursor[u];
+				Workers[c].Count += Workers[t].Count;
+				Workers[c].End = Workers[t].End;
+				free(Workers[t].Cursor);
+			}
+		}
+		Threads = g;
+	}
+
+	/* Row u holds the edges of u from each range in turn, so each thread's
+	 * edges of u start after those of the threads before it */
+	G = graph_construct_sparse(n);
+	G->EdgeTarget = (int *) malloc((Total + 1) * sizeof(int));
+	G->EdgeWeight = (double *) malloc((Total + 1) * sizeof(double));
+	if(G->EdgeTarget == NULL || G->EdgeWeight == NULL)
+	{
+		printf("Failed to allocate the edges of %s!\n", Path);
+		exit(1);
+	}
+	for(u=0, e=0; u<n; u++)
+	{
+		G->EdgeOffset[u] = e;
+		for(t=0; t<Threads; t++)
+		{
+			c = Workers[t].Cursor[u];
+			Workers[t].Cursor[u] = e;
+			e += c;
+		}
+	}
+	G->EdgeOffset[n] = e;
+
+	for(t=0; t<Threads; t++)
+	{
+		Workers[t].Storing = TRUE;
+		Workers[t].G = G;
+		Counted[t] = Workers[t].Count;
+		Workers[t].Count = 0;
+	}
+	ReadAll(Workers, Threads);
+	close(Workers[0].File);
+	for(t=0; t<Threads; t++)
+	{
+		if(Workers[t].Count != Counted[t])
+		{
+			fprintf(stderr, "%s changed while it was being read\n", Path);
+			exit(1);
+		}
+		free(Workers[t].Cursor);
+	}
+	free(Workers);
+	free(Counted);
+
+	G->EdgeCount = (int) Total;
+	G->CSRValid = FALSE;
+	graph_finalize(G);
+
+	return G;
+}
@@ -0,0 +1,21 @@
+/* reader.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * Reads a graph from a DIMACS shortest path file or a plain edge list into
+ * compressed sparse row form.  Include graph.h before this file.
+ *
+ * DIMACS (.gr) files have a "p sp N M" line and "a U V W" arcs numbered from
+ * 1, with comment lines starting with c.  Edge lists have "U V [W]" lines
+ * numbered from 0, a weight of 1 when W is left out, and comment lines
+ * starting with # or %.  A file is read as DIMACS if its first word is c, p
+ * or a.
+ */
+
+#define READ_CHUNK (1 << 20)	//Bytes each thread reads at a time
+#define READ_BATCH 4096			//Edges each thread parses before storing them
+#define READ_SHARE 4			//Edge array bytes for each byte of the threads' vertex counts
+
+graph_t* graph_read(const char *Path, int Threads);
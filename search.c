@@ -0,0 +1,193 @@
+/* search.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * This file contains a resumable Dijkstra search.  Each call confirms only as
+ * many vertices as it needs: up to a destination, the next K nearest, or all
+ * within a distance.  A range query has to look at the closest unconfirmed
+ * vertex without confirming it, and since the queues in pqueue.h can only
+ * remove their smallest item, that item is kept aside in Next until it is
+ * confirmed.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <float.h>
+
+#include "graph.h"
+#include "heap.h"
+#include "pqueue.h"
+#include "search.h"
+#include "counters.h"
+
+
+/* Sets up S, whose arrays and queue are ready, to search from LSource */
+static void SearchStart(search_t *S, graph_t *G, int LSource)
+{
+	int u;
+	PQItem Item;
+
+	S->G = G;
+	S->Source = LSource;
+	S->Settled = 0;
+	S->HasNext = FALSE;
+	for(u = 0; u < G->NumVert; u++) {
+		S->Pred[u] = u;					//Stays u if the vertex is never reached
+		S->ShDis[u] = FLT_MAX;
+	}
+
+	S->ShDis[LSource] = 0;
+	Item.node = LSource;
+	Item.weight = 0;
+	S->Ops->Insert(Item, S->PQ);
+}
+
+/* Starts a search from LSource with the queue Ops, or a 4-ary heap if Ops is
+ * NULL.  No vertex is confirmed until one of the calls below asks for it.
+ */
+search_t* search_construct(graph_t *G, const PQOps *Ops, int LSource)
+{
+	search_t *S;
+
+	graph_finalize(G);
+	S = (search_t *) malloc(sizeof(search_t));
+	S->WS = NULL;
+	S->Ops = (Ops != NULL) ? Ops : &PQDHeap4;
+	S->PQ = S->Ops->Initialize(G->NumVert);
+	S->Order = (int *) malloc(G->NumVert * sizeof(int));
+	S->Done = (int *) calloc(G->NumVert, sizeof(int));
+	S->Pred = (int *) malloc(G->NumVert * sizeof(int));
+	S->ShDis = (double *) malloc(G->NumVert * sizeof(double));
+	COUNT(BytesAllocated, sizeof(search_t) + G->NumVert * (3 * sizeof(int) + sizeof(double)));
+	SearchStart(S, G, LSource);
+	return S;
+}
+
+/* search_construct with the arrays and queue of WS, so a run of searches
+ * allocates nothing but the search_t after the first.  The results are in
+ * WS->Pred and WS->Dist, and WS mustn't be used for anything else until S is
+ * destructed.
+ */
+search_t* search_construct_with(graph_t *G, const PQOps *Ops, int LSource, SPWorkspace *WS)
+{
+	int u;
+	search_t *S;
+
+	graph_finalize(G);
+	S = (search_t *) malloc(sizeof(search_t));
+	COUNT(BytesAllocated, sizeof(search_t));
+	S->WS = WS;
+	S->Ops = (Ops != NULL) ? Ops : &PQDHeap4;
+	S->PQ = workspace_prepare(WS, G->NumVert, S->Ops);
+	S->Order = WS->Order;
+	S->Done = WS->Mark;
+	S->Pred = WS->Pred;
+	S->ShDis = WS->Dist;
+	for(u = 0; u < G->NumVert; u++) S->Done[u] = FALSE;
+	SearchStart(S, G, LSource);
+	return S;
+}
+
+/* Frees search S, and empties the queue it borrowed from a workspace */
+void search_destruct(search_t *S)
+{
+	if(S->WS != NULL)
+	{
+		while(!S->Ops->Empty(S->PQ)) S->Ops->Remove(S->PQ);
+		free(S);
+		return;
+	}
+	S->Ops->Destruct(S->PQ);
+	free(S->Order); free(S->Done); free(S->Pred); free(S->ShDis);
+	free(S);
+}
+
+/* Takes the closest unconfirmed vertex off the queue into Next, unless it is
+ * already there.  Returns FALSE if every reachable vertex is confirmed.
+ */
+static int search_peek(search_t *S)
+{
+	if(!S->HasNext && !S->Ops->Empty(S->PQ))
+	{
+		S->Next = S->Ops->Remove(S->PQ);
+		S->HasNext = TRUE;
+	}
+	return S->HasNext;
+}
+
+/* Confirms the closest unconfirmed vertex and updates its neighbors.  Returns
+ * the vertex, or -1 if every reachable vertex is already confirmed.
+ */
+int search_step(search_t *S)
+{
+	int u, w, e;
+	double cost_to_u_via_w;
+	graph_t *G = S->G;
+	PQItem Item;
+
+	if(!search_peek(S)) return -1;
+	w = S->Next.node;
+	S->HasNext = FALSE;
+	S->Done[w] = TRUE;
+	S->Order[S->Settled++] = w;
+	COUNT(Settled, 1);
+	COUNT(EdgesScanned, G->EdgeOffset[w+1] - G->EdgeOffset[w]);
+
+	for(e = G->EdgeOffset[w]; e < G->EdgeOffset[w+1]; e++)
+	{
+		u = G->EdgeTarget[e];
+		if (S->Done[u] || G->EdgeWeight[e] == FLT_MAX) continue;
+
+		cost_to_u_via_w = S->ShDis[w] + G->EdgeWeight[e];
+		if (cost_to_u_via_w < S->ShDis[u])
+		{
+			COUNT(Relaxations, 1);
+			S->ShDis[u] = cost_to_u_via_w;
+			S->Pred[u] = w;
+			Item.node = u;
+			Item.weight = cost_to_u_via_w;
+			S->Ops->Insert(Item, S->PQ);		//Inserts or moves u up in the queue
+		}
+	}
+	return w;
+}
+
+/* Confirms vertices until LDest is confirmed.  Returns FALSE if LDest can't
+ * be reached from the source.
+ */
+int search_until(search_t *S, int LDest)
+{
+	while(!S->Done[LDest])
+		if(search_step(S) < 0) return FALSE;
+	return TRUE;
+}
+
+/* Confirms up to K more vertices, which are then the last entries of Order.
+ * Returns how many were confirmed, fewer than K if the search ran out.
+ */
+int search_next(search_t *S, int K)
+{
+	int i;
+
+	for(i = 0; i < K; i++)
+		if(search_step(S) < 0) break;
+	return i;
+}
+
+/* Confirms every vertex with a cost of at most Radius.  Returns how many
+ * vertices that is, counting the source; they are the first entries of Order.
+ */
+int search_within(search_t *S, double Radius)
+{
+	int Count;
+
+	while(search_peek(S) && S->Next.weight <= Radius)
+		search_step(S);
+
+	/* Earlier calls may have confirmed vertices past Radius already */
+	Count = S->Settled;
+	while(Count > 0 && S->ShDis[S->Order[Count-1]] > Radius) Count--;
+	return Count;
+}
@@ -0,0 +1,35 @@
+/* search.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * A Dijkstra search from one source that confirms vertices only when asked,
+ * and picks up where the last call stopped.  The graph must not change while
+ * a search is in use.  Include graph.h and pqueue.h before this file.
+ */
+
+/* State of one search.  Pred and ShDis follow ShortestPath, but only the
+ * first Settled vertices of Order, nearest first, have their final values */
+typedef  struct {
+	graph_t	*G;
+	SPWorkspace *WS;				//Owner of the arrays and queue, or NULL
+	const PQOps *Ops;
+	void	*PQ;
+	int		Source;
+	int		Settled;				//Vertices confirmed so far
+	int		*Order;					//Confirmed vertices in order of cost
+	int		*Done;					//TRUE once a vertex is confirmed
+	int		*Pred;
+	double	*ShDis;
+	int		HasNext;				//Next holds the closest unconfirmed vertex,
+	PQItem	Next;					//already taken off the queue
+} search_t;
+
+search_t* search_construct(graph_t *G, const PQOps *Ops, int LSource);
+search_t* search_construct_with(graph_t *G, const PQOps *Ops, int LSource, SPWorkspace *WS);
+void search_destruct(search_t *S);
+int search_step(search_t *S);
+int search_until(search_t *S, int LDest);
+int search_next(search_t *S, int K);
+int search_within(search_t *S, double Radius);
@@ -0,0 +1,204 @@
+/* snapshot.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * This file saves a graph to a snapshot file and loads it back.  Loading maps
+ * the file into memory and points the CSR arrays and the vertex positions of
+ * the graph straight into the mapping, so nothing is parsed or copied and a
+ * large graph is ready as soon as its pages are read.
+ *
+ * The mapping is private and writable: graph_set_weight may change a weight
+ * in place without touching the file, and graph_finalize moves the edges to
+ * the heap the first time it has to rebuild them.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+#include "snapshot.h"
+
+
+/* Rounds Pos up to the next multiple of SNAPSHOT_ALIGN */
+static uint64_t AlignPos(uint64_t Pos)
+{
+	return (Pos + SNAPSHOT_ALIGN - 1) / SNAPSHOT_ALIGN * SNAPSHOT_ALIGN;
+}
+
+/* Writes Bytes from Data at position Pos of File, padding with zeros from
+ * the current position */
+static void WriteAt(FILE *File, uint64_t Pos, const void *Data, size_t Bytes)
+{
+	static const char Zero[SNAPSHOT_ALIGN];
+	long Here = ftell(File);
+
+	if(Pos > (uint64_t) Here) fwrite(Zero, 1, Pos - Here, File);
+	if(Bytes > 0 && fwrite(Data, 1, Bytes, File) != Bytes)
+	{
+		fprintf(stderr, "failed to write the snapshot\n");
+		exit(1);
+	}
+}
+
+/* Saves the edges of G, and the vertex positions if every vertex has one, to
+ * the file Path.  GraphType is stored for lab6 to report when loading.
+ */
+void graph_save(graph_t *G, int GraphType, const char *Path)
+{
+	int i, e, n, Live, *Offset, *Target;
+	double *Weight;
+	GraphItem *Items;
+	SnapshotHeader H;
+	FILE *File;
+
+	n = G->NumVert;
+	graph_finalize(G);
+
+	/* Copy the edges without the ones left behind by removals */
+	Offset = (int *) malloc((n + 1) * sizeof(int));
+	Target = (int *) malloc((G->EdgeOffset[n] + 1) * sizeof(int));
+	Weight = (double *) malloc((G->EdgeOffset[n] + 1) * sizeof(double));
+	for(i=0, Live=0; i<n; i++)
+	{
+		Offset[i] = Live;
+		for(e = G->EdgeOffset[i]; e < G->EdgeOffset[i+1]; e++)
+		{
+			if(G->EdgeWeight[e] == FLT_MAX) continue;
+			Target[Live] = G->EdgeTarget[e];
+			Weight[Live] = G->EdgeWeight[e];
+			Live++;
+		}
+	}
+	Offset[n] = Live;
+
+	Items = NULL;
+	for(i=0; i<n && G->VertArray[i] != NULL; i++)
+		;
+	if(n > 0 && i == n)
+	{
+		Items = (GraphItem *) malloc(n * sizeof(GraphItem));
+		for(i=0; i<n; i++) Items[i] = *G->VertArray[i];
+	}
+
+	memset(&H, 0, sizeof(H));
+	memcpy(H.Magic, SNAPSHOT_MAGIC, sizeof(H.Magic));
+	H.Version = SNAPSHOT_VERSION;
+	H.ItemSize = sizeof(GraphItem);
+	H.NumVert = n;
+	H.GraphType = GraphType;
+	H.EdgeCount = G->EdgeCount;
+	H.NumEdges = Live;
+	H.OffsetPos = AlignPos(sizeof(H));
+	H.TargetPos = AlignPos(H.OffsetPos + (n + 1) * sizeof(int));
+	H.WeightPos = AlignPos(H.TargetPos + Live * sizeof(int));
+	H.ItemPos = Items == NULL ? 0 : AlignPos(H.WeightPos + Live * sizeof(double));
+
+	File = fopen(Path, "wb");
+	if(File == NULL)
+	{
+		fprintf(stderr, "cannot open snapshot file: %s\n", Path);
+		exit(1);
+	}
+	WriteAt(File, 0, &H, sizeof(H));
+	WriteAt(File, H.OffsetPos, Offset, (n + 1) * sizeof(int));
+	WriteAt(File, H.TargetPos, Target, Live * sizeof(int));
+	WriteAt(File, H.WeightPos, Weight, Live * sizeof(double));
+	if(Items != NULL) WriteAt(File, H.ItemPos, Items, n * sizeof(GraphItem));
+	if(fclose(File) != 0)
+	{
+		fprintf(stderr, "failed to write the snapshot\n");
+		exit(1);
+	}
+
+	free(Offset); free(Target); free(Weight); free(Items);
+}
+
+/* Maps the snapshot file Path and returns a sparse graph that uses it in
+ * place.  The graph type it was saved with is stored in *GraphType.
+ *
+ * Only the header and the ends of the offsets are checked; the edges are
+ * trusted, as checking them would mean reading the whole file.
+ */
+graph_t* graph_load(const char *Path, int *GraphType)
+{
+	int i, fd, *Offset;
+	char *Base;
+	uint64_t End;
+	struct stat Info;
+	SnapshotHeader H;
+	GraphItem *Items;
+	graph_t *G;
+
+	fd = open(Path, O_RDONLY);
+	if(fd < 0 || fstat(fd, &Info) != 0)
+	{
+		fprintf(stderr, "cannot open snapshot file: %s\n", Path);
+		exit(1);
+	}
+	if((size_t) Info.st_size < sizeof(H) || pread(fd, &H, sizeof(H), 0) != sizeof(H)
+		|| memcmp(H.Magic, SNAPSHOT_MAGIC, sizeof(H.Magic)) != 0)
+	{
+		fprintf(stderr, "not a graph snapshot: %s\n", Path);
+		exit(1);
+	}
+	if(H.Version != SNAPSHOT_VERSION || H.ItemSize != sizeof(GraphItem))
+	{
+		fprintf(stderr, "snapshot %s has version %u and item size %u, expected %d and %d\n",
+				Path, H.Version, H.ItemSize, SNAPSHOT_VERSION, (int) sizeof(GraphItem));
+		exit(1);
+	}
+
+	/* Every array must lie inside the file */
+	End = H.WeightPos + (uint64_t) H.NumEdges * sizeof(double);
+	if(H.ItemPos > 0) End = H.ItemPos + (uint64_t) H.NumVert * sizeof(GraphItem);
+	if(H.NumVert < 0 || H.NumEdges < 0 || End > (uint64_t) Info.st_size
+		|| H.OffsetPos + (H.NumVert + 1) * sizeof(int) > H.TargetPos
+		|| H.TargetPos + (uint64_t) H.NumEdges * sizeof(int) > H.WeightPos
+		|| H.OffsetPos % SNAPSHOT_ALIGN || H.TargetPos % SNAPSHOT_ALIGN
+		|| H.WeightPos % SNAPSHOT_ALIGN || H.ItemPos % SNAPSHOT_ALIGN)
+	{
+		fprintf(stderr, "snapshot %s is damaged\n", Path);
+		exit(1);
+	}
+
+	Base = mmap(NULL, Info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(Base == MAP_FAILED)
+	{
+		fprintf(stderr, "cannot map snapshot file: %s\n", Path);
+		exit(1);
+	}
+	Offset = (int *) (Base + H.OffsetPos);
+	if(Offset[0] != 0 || Offset[H.NumVert] != H.NumEdges)
+	{
+		fprintf(stderr, "snapshot %s is damaged\n", Path);
+		exit(1);
+	}
+
+	G = graph_construct_sparse(H.NumVert);
+	free(G->EdgeOffset);
+	G->EdgeOffset = Offset;
+	G->EdgeTarget = (int *) (Base + H.TargetPos);
+	G->EdgeWeight = (double *) (Base + H.WeightPos);
+	G->EdgeCount = H.EdgeCount;
+	G->EdgesMapped = TRUE;
+	G->MapBase = Base;
+	G->MapSize = Info.st_size;
+
+	if(H.ItemPos > 0)
+	{
+		Items = (GraphItem *) (Base + H.ItemPos);
+		for(i=0; i<H.NumVert; i++) G->VertArray[i] = &Items[i];
+	}
+
+	*GraphType = H.GraphType;
+	return G;
+}
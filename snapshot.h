@@ -0,0 +1,38 @@
+/* snapshot.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * A binary file holding a graph in CSR form, which graph_load maps into
+ * memory and uses in place.  Include graph.h before this file.
+ */
+
+#include <stdint.h>
+
+#define SNAPSHOT_MAGIC "LAB6GRPH"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ALIGN 64		//Each array starts on a cache line
+
+/* Start of the file.  The arrays follow at the given byte positions, in the
+ * byte order of the machine that wrote them:
+ *	 EdgeOffset		NumVert+1 ints
+ *	 EdgeTarget		NumEdges ints
+ *	 EdgeWeight		NumEdges doubles
+ *	 Items			NumVert GraphItems holding the positions, if ItemPos > 0 */
+typedef  struct {
+	char		Magic[8];
+	uint32_t	Version;
+	uint32_t	ItemSize;			//sizeof(GraphItem) when written
+	int32_t		NumVert;
+	int32_t		GraphType;			//-g of the graph, for the prints in lab6
+	int32_t		EdgeCount;			//G->EdgeCount, the edges that were added
+	int32_t		NumEdges;			//Edges in the CSR arrays
+	uint64_t	OffsetPos;
+	uint64_t	TargetPos;
+	uint64_t	WeightPos;
+	uint64_t	ItemPos;
+} SnapshotHeader;
+
+void graph_save(graph_t *G, int GraphType, const char *Path);
+graph_t* graph_load(const char *Path, int *GraphType);
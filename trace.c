@@ -0,0 +1,125 @@
+/* trace.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * This file keeps the buffer of trace events from trace.h, writes it to a
+ * trace file, and turns the events back into text.  Recording an event only
+ * fills in 24 bytes, so a search traced on a large graph runs close to its
+ * normal speed; the printing happens afterwards, outside the timed part.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "trace.h"
+
+TraceEvent *TraceBuffer = NULL;
+long TraceCount = 0;
+
+static FILE *TraceFile = NULL;
+
+
+/* Allocates the buffer and, if Path isn't NULL, starts the trace file Path */
+void trace_open(const char *Path)
+{
+	TraceHeader H;
+
+	if(TraceBuffer == NULL)
+		TraceBuffer = (TraceEvent *) malloc(TRACE_EVENTS * sizeof(TraceEvent));
+	if(Path == NULL) return;
+
+	if((TraceFile = fopen(Path, "wb")) == NULL)
+	{
+		fprintf(stderr, "cannot open trace file: %s\n", Path);
+		exit(1);
+	}
+	memset(&H, 0, sizeof(H));
+	memcpy(H.Magic, TRACE_MAGIC, sizeof(H.Magic));
+	H.Version = TRACE_VERSION;
+	H.EventSize = sizeof(TraceEvent);
+	fwrite(&H, sizeof(H), 1, TraceFile);
+}
+
+/* Writes the events in the buffer to the trace file.  Without a file, a full
+ * buffer just starts overwriting its oldest events.
+ */
+void trace_flush(void)
+{
+	long Count = TraceCount & (TRACE_EVENTS - 1);
+
+	if(TraceFile == NULL) return;
+	if(Count == 0 && TraceCount > 0) Count = TRACE_EVENTS;
+	if(Count > 0 && fwrite(TraceBuffer, sizeof(TraceEvent), Count, TraceFile) != (size_t) Count)
+	{
+		fprintf(stderr, "failed to write the trace file\n");
+		exit(1);
+	}
+	TraceCount = 0;
+}
+
+/* Writes out the last events and closes the trace file */
+void trace_close(void)
+{
+	if(TraceFile != NULL)
+	{
+		trace_flush();
+		fclose(TraceFile);
+		TraceFile = NULL;
+	}
+	free(TraceBuffer);
+	TraceBuffer = NULL;
+	TraceCount = 0;
+}
+
+/* Prints the events in the buffer, oldest first, and empties it */
+void trace_print(FILE *Out)
+{
+	long i, First;
+
+	if(TraceBuffer == NULL || TraceFile != NULL) return;
+	First = 0;
+	if(TraceCount > TRACE_EVENTS)
+	{
+		First = TraceCount - TRACE_EVENTS;
+		fprintf(Out, "(%ld earlier trace events were dropped)\n", First);
+	}
+	for(i = First; i < TraceCount; i++)
+		trace_print_event(Out, &TraceBuffer[i & (TRACE_EVENTS - 1)]);
+	TraceCount = 0;
+}
+
+/* Prints one event as a line of text */
+void trace_print_event(FILE *Out, const TraceEvent *E)
+{
+	static const char *Way[] = {"", " forward", " backward", ""};
+	const char *Side = Way[E->Side & 3];
+
+	switch(E->Kind) {
+		case TRACE_START:
+			if(E->Other < 0) fprintf(Out, "Starting at node %d\n", E->Vertex);
+			else if(E->Side == TRACE_BOTH) fprintf(Out, "Starting at node %d and node %d\n", E->Vertex, E->Other);
+			else fprintf(Out, "Starting at node %d toward node %d, %g per unit of distance\n", E->Vertex, E->Other, E->Cost);
+			break;
+		case TRACE_SETTLE:
+			fprintf(Out, "%d: %d confirmed%s with cost %g and %s %d\n", E->Step, E->Vertex, Side, E->Cost,
+					E->Side == TRACE_BACKWARD ? "successor" : "predecessor", E->Other);
+			break;
+		case TRACE_RELAX:
+			fprintf(Out, "\tdest %d has lower cost %g%s with %s %d\n", E->Vertex, E->Cost, Side,
+					E->Side == TRACE_BACKWARD ? "successor" : "predecessor", E->Other);
+			break;
+		case TRACE_FOUND:
+			fprintf(Out, "Reached node %d with cost %g\n", E->Vertex, E->Cost);
+			break;
+		case TRACE_DONE:
+			fprintf(Out, "Found %d nodes, including source%s\n", E->Step,
+					E->Side == TRACE_BOTH ? " and destination" : "");
+			break;
+		default:
+			fprintf(Out, "unknown trace event %d\n", E->Kind);
+			break;
+	}
+}
@@ -0,0 +1,74 @@
+/* trace.h
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * A trace of what the shortest path searches do with -v.  Each step is
+ * stored as a fixed-size binary event instead of being printed, either in a
+ * ring buffer holding the latest TRACE_EVENTS events, printed once the
+ * operation is done, or in a file that tracedump prints.  Tracing is for one
+ * thread at a time; the diameter search turns it off with several threads.
+ * Include stdio.h before this file.
+ */
+
+#define TRACE_EVENTS (1 << 16)		//Events in the buffer, a power of two
+#define TRACE_MAGIC "LAB6TRCE"
+#define TRACE_VERSION 1
+
+/* Kinds of event */
+#define TRACE_START 1		//Vertex is the source, Other the destination or -1
+#define TRACE_SETTLE 2		//Vertex confirmed with cost Cost and predecessor Other
+#define TRACE_RELAX 3		//Vertex given the lower cost Cost through Other
+#define TRACE_FOUND 4		//The destination Vertex was reached with cost Cost
+#define TRACE_DONE 5		//The search ended with Step vertices confirmed
+
+/* Sides of a search, for the search from both ends */
+#define TRACE_ONE_WAY 0
+#define TRACE_FORWARD 1
+#define TRACE_BACKWARD 2
+#define TRACE_BOTH 3
+
+typedef  struct {
+	unsigned char	Kind;
+	unsigned char	Side;
+	short			Unused;
+	int				Vertex;
+	int				Other;
+	int				Step;			//Count of vertices confirmed so far
+	double			Cost;
+} TraceEvent;
+
+/* Start of a trace file, followed by the events */
+typedef  struct {
+	char			Magic[8];
+	unsigned int	Version;
+	unsigned int	EventSize;		//sizeof(TraceEvent) when written
+} TraceHeader;
+
+extern TraceEvent *TraceBuffer;
+extern long TraceCount;				//Events recorded since the last print or flush
+
+void trace_open(const char *Path);
+void trace_flush(void);
+void trace_close(void);
+void trace_print(FILE *Out);
+void trace_print_event(FILE *Out, const TraceEvent *E);
+
+/* Records an event.  The buffer is written out to the trace file whenever it
+ * fills; without a file the oldest events are overwritten. */
+static inline void trace_event(int Kind, int Side, int Vertex, int Other, int Step, double Cost)
+{
+	TraceEvent *E;
+
+	if(TraceBuffer == NULL) trace_open(NULL);
+	E = &TraceBuffer[TraceCount & (TRACE_EVENTS - 1)];
+	E->Kind = Kind;
+	E->Side = Side;
+	E->Unused = 0;
+	E->Vertex = Vertex;
+	E->Other = Other;
+	E->Step = Step;
+	E->Cost = Cost;
+	if((++TraceCount & (TRACE_EVENTS - 1)) == 0) trace_flush();
+}
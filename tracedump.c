@@ -0,0 +1,59 @@
+/* tracedump.c
+ * Roderick "Rance" White
+ * roderiw
+ * Lab6: Graphs
+ * ECE 2230, Fall 2020
+ *
+ * Prints a trace file written by lab6 -T as text, in the same form lab6 -v
+ * prints its trace.
+ *
+ * Usage: tracedump FILE
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "trace.h"
+
+#define DUMP_CHUNK 4096			//Events read at a time
+
+
+int main(int argc, char **argv)
+{
+	TraceHeader H;
+	TraceEvent *Events;
+	size_t i, Got;
+	FILE *In;
+
+	if(argc != 2)
+	{
+		fprintf(stderr, "Usage: %s FILE\n", argv[0]);
+		exit(1);
+	}
+	if((In = fopen(argv[1], "rb")) == NULL)
+	{
+		fprintf(stderr, "cannot open trace file: %s\n", argv[1]);
+		exit(1);
+	}
+	if(fread(&H, sizeof(H), 1, In) != 1 || memcmp(H.Magic, TRACE_MAGIC, sizeof(H.Magic)) != 0)
+	{
+		fprintf(stderr, "not a trace file: %s\n", argv[1]);
+		exit(1);
+	}
+	if(H.Version != TRACE_VERSION || H.EventSize != sizeof(TraceEvent))
+	{
+		fprintf(stderr, "trace %s has version %u and event size %u, expected %d and %d\n",
+				argv[1], H.Version, H.EventSize, TRACE_VERSION, (int) sizeof(TraceEvent));
+		exit(1);
+	}
+
+	Events = (TraceEvent *) malloc(DUMP_CHUNK * sizeof(TraceEvent));
+	while((Got = fread(Events, sizeof(TraceEvent), DUMP_CHUNK, In)) > 0)
+		for(i = 0; i < Got; i++)
+			trace_print_event(stdout, &Events[i]);
+
+	free(Events);
+	fclose(In);
+	return 0;
+}